@@ -0,0 +1,107 @@
+// Plays a headless game through a series of shots and counts calls to the
+// global heap in every frame. Once the course around the ball has been built,
+// a frame should not allocate at all: transient containers come from the
+// game's frame arena. Exits with 1 if a steady-state frame allocated.
+//
+// Usage: frame-bench [shots] [framesPerShot] [metricsFile]
+//
+// With a metrics file, every frame is also recorded (.csv, .jsonl or binary)
+// so runs of different builds can be compared frame by frame.
+
+#include "../src/core/Game.hpp"
+#include "../src/core/MetricsRecorder.hpp"
+#include "../src/entities/Ball.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+
+namespace {
+    std::atomic<std::size_t> allocationCount{0};
+}
+
+// Count every allocation made through the global operator new
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+namespace {
+    const float DeltaTime = 1.f / 144.f;
+    const int WarmupFrames = 288;       // Long enough to build the chunks around the spawn point
+    const float ShotLength = 80.f;      // Drag distance; short enough to stay in the built chunks
+    
+    using BenchClock = std::chrono::steady_clock;
+}
+
+int main(int argc, char* argv[]) {
+    int shots = argc > 1 ? std::atoi(argv[1]) : 20;
+    int framesPerShot = argc > 2 ? std::atoi(argv[2]) : 300;
+    
+    Game game(600, 600, true);
+    game.addEntity(std::make_unique<Ball>());
+    if (argc > 3 && !game.recordMetrics(argv[3])) {
+        std::fprintf(stderr, "Could not open metrics file %s\n", argv[3]);
+        return 1;
+    }
+    Ball* ball = game.findBall();
+    
+    // Let the generator build the course and every lazily sized buffer settle
+    for (int frame = 0; frame < WarmupFrames; ++frame) {
+        game.step(DeltaTime);
+    }
+    
+    std::size_t allocatingFrames = 0;
+    std::size_t totalAllocations = 0;
+    std::size_t maxAllocations = 0;
+    double totalMs = 0.0;
+    int frames = 0;
+    
+    for (int shot = 0; shot < shots; ++shot) {
+        // Alternate left and right so the ball stays on the same stretch of course
+        sf::Vector2f position = ball->getPosition();
+        float pull = shot % 2 == 0 ? -ShotLength : ShotLength;
+        ball->handleMousePress(position);
+        ball->handleMouseRelease(position + sf::Vector2f(pull, 0.f));
+        
+        for (int frame = 0; frame < framesPerShot; ++frame) {
+            std::size_t before = allocationCount.load(std::memory_order_relaxed);
+            auto start = BenchClock::now();
+            game.step(DeltaTime);
+            totalMs += std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+            std::size_t allocations = allocationCount.load(std::memory_order_relaxed) - before;
+            
+            if (allocations > 0) allocatingFrames++;
+            totalAllocations += allocations;
+            maxAllocations = std::max(maxAllocations, allocations);
+            frames++;
+        }
+    }
+    
+    const FrameArena& arena = game.getFrameArena();
+    std::printf("Headless frames: %d (%d shots), %.3f ms/frame\n", frames, shots, totalMs / frames);
+    std::printf("Heap allocations: %zu total, %zu frames allocating, at most %zu in one frame\n",
+                totalAllocations, allocatingFrames, maxAllocations);
+    std::printf("Frame arena: %zu bytes, peak %zu bytes (debug builds), %zu overflows\n",
+                arena.getCapacity(), arena.getPeak(), arena.getOverflowCount());
+    if (game.getMetrics()) {
+        game.getMetrics()->writeSummary(std::cout);
+    }
+    
+    return allocatingFrames == 0 ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+// Records ball runs as compressed ghost tracks and measures what they cost:
+// encoded bytes per minute of trajectory against raw positions, the error
+// quantisation adds, random access through keyframes, and the per-frame
+// decode time and draw calls of playing every ghost at once. Exits with 1 if a
+// decoded position is further from the recorded one than quantisation allows
+// or if the ghosts took more than one draw call.
+//
+// Usage: ghost-bench [ghosts] [seconds]
+
+#include "../src/entities/Ball.hpp"
+#include "../src/systems/GhostSystem.hpp"
+#include "../src/systems/GhostTrack.hpp"
+#include "../src/utils/CountingRenderTarget.hpp"
+#include "../src/utils/MemoryTracker.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+    const float DeltaTime = 1.f / 144.f;
+    const float ShotInterval = 3.f;         // Seconds between shots; the ball mostly stops in between
+    const float MaxShotSpeed = 1000.f;
+    const int SeekCount = 100000;
+    
+    using BenchClock = std::chrono::steady_clock;
+    
+    double microsecondsSince(BenchClock::time_point start) {
+        return std::chrono::duration<double, std::micro>(BenchClock::now() - start).count();
+    }
+    
+    // Play random shots with the game's ball, sampling it at each tick like the game's recorder
+    void recordRun(std::mt19937& rng, float seconds, GhostTrack& track, std::vector<sf::Vector2f>& positions) {
+        std::uniform_real_distribution<float> angle(0.f, 2.f * 3.14159f);
+        std::uniform_real_distribution<float> speed(100.f, MaxShotSpeed);
+        
+        Ball ball;
+        float time = 0.f;
+        float nextShot = 0.f;
+        sf::Vector2f previous = ball.getPosition();
+        while (time < seconds) {
+            if (time >= nextShot) {
+                float direction = angle(rng);
+                ball.setVelocity(sf::Vector2f(std::cos(direction), std::sin(direction)) * speed(rng));
+                nextShot += ShotInterval;
+            }
+            ball.update(DeltaTime);
+            time += DeltaTime;
+            
+            std::uint32_t tick = static_cast<std::uint32_t>(time * GhostTrack::TickRate);
+            while (track.getTickCount() <= tick) {
+                float t = 1.f - (time - track.getTickCount() / GhostTrack::TickRate) / DeltaTime;
+                sf::Vector2f position = previous + (ball.getPosition() - previous) * std::clamp(t, 0.f, 1.f);
+                track.append(position);
+                positions.push_back(position);
+            }
+            previous = ball.getPosition();
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int ghostCount = argc > 1 ? std::atoi(argv[1]) : 500;
+    float seconds = argc > 2 ? static_cast<float>(std::atof(argv[2])) : 60.f;
+    
+    // Record and check every run
+    std::mt19937 rng(42);
+    std::vector<GhostTrack> tracks(ghostCount);
+    std::vector<sf::Vector2f> positions;
+    std::size_t encodedBytes = 0;
+    std::uint64_t ticks = 0;
+    float maxError = 0.f;
+    for (GhostTrack& track : tracks) {
+        positions.clear();
+        recordRun(rng, seconds, track, positions);
+        
+        GhostTrack::Cursor cursor;
+        for (std::uint32_t tick = 0; tick < track.getTickCount(); ++tick) {
+            track.seek(cursor, tick);
+            sf::Vector2f error = cursor.position() - positions[tick];
+            maxError = std::max(maxError, std::max(std::abs(error.x), std::abs(error.y)));
+        }
+        encodedBytes += track.getByteSize();
+        ticks += track.getTickCount();
+    }
+    
+    float minutes = ticks / GhostTrack::TickRate / 60.f;
+    double rawBytes = static_cast<double>(ticks) * sizeof(sf::Vector2f);
+    float errorBound = 0.5f / GhostTrack::Resolution + 1e-3f;
+    std::printf("Recorded %d runs of %.0f s (%llu ticks at %.0f Hz)\n", ghostCount, seconds,
+                static_cast<unsigned long long>(ticks), GhostTrack::TickRate);
+    std::printf("  encoded  %8.1f KB per minute (%.2f bytes per tick)\n",
+                encodedBytes / 1024.0 / minutes, static_cast<double>(encodedBytes) / ticks);
+    std::printf("  raw      %8.1f KB per minute (%.1fx smaller encoded)\n",
+                rawBytes / 1024.0 / minutes, rawBytes / encodedBytes);
+    std::printf("  max error %.4f px (bound %.4f)\n", maxError, errorBound);
+    
+    // Random access: every seek starts from a fresh cursor
+    std::uniform_int_distribution<int> pickTrack(0, ghostCount - 1);
+    float checksum = 0.f;
+    auto seekStart = BenchClock::now();
+    for (int i = 0; i < SeekCount; ++i) {
+        const GhostTrack& track = tracks[pickTrack(rng)];
+        std::uniform_int_distribution<std::uint32_t> pickTick(0, track.getTickCount() - 1);
+        checksum += track.positionAt(pickTick(rng)).x;
+    }
+    std::printf("Random seek: %.3f us (checksum %.0f)\n", microsecondsSince(seekStart) / SeekCount, checksum);
+    
+    // Play every ghost at once, drawing into a counting target with nothing behind it
+    GhostSystem ghosts(tracks.size());
+    for (GhostTrack& track : tracks) {
+        ghosts.addGhost(std::move(track));
+    }
+    CountingRenderTarget target;
+    double decodeMicroseconds = 0.0;
+    float maxDecodeMicroseconds = 0.f;
+    std::uint64_t ticksDecoded = 0;
+    std::uint32_t maxDrawCalls = 0;
+    int frames = 0;
+    for (float time = 0.f; time < seconds; time += DeltaTime) {
+        ghosts.update(DeltaTime);
+        target.resetStats();
+        ghosts.draw(target);
+        
+        const GhostStats& stats = ghosts.getStats();
+        decodeMicroseconds += stats.decodeMicroseconds;
+        maxDecodeMicroseconds = std::max(maxDecodeMicroseconds, stats.decodeMicroseconds);
+        ticksDecoded += stats.ticksDecoded;
+        maxDrawCalls = std::max(maxDrawCalls, target.getTotals().drawCalls);
+        frames++;
+    }
+    
+    const GhostStats& stats = ghosts.getStats();
+    std::printf("Playback: %zu ghosts, %d frames at %.0f Hz\n", stats.ghosts, frames, 1.f / DeltaTime);
+    std::printf("  decode   %8.1f us per frame (max %.1f), %.1f ticks per frame\n",
+                decodeMicroseconds / frames, maxDecodeMicroseconds, static_cast<double>(ticksDecoded) / frames);
+    std::printf("  draws    %u per frame at most\n", maxDrawCalls);
+    std::printf("  memory   %.1f KB of tracks (%.1f KB per minute), %.1f KB tagged ghosts\n",
+                stats.trackBytes / 1024.0, stats.bytesPerMinute() / 1024.0,
+                Memory::getStats(Memory::Tag::Ghosts).liveBytes / 1024.0);
+    
+    return maxError <= errorBound && maxDrawCalls <= 1 ? 0 : 1;
+}
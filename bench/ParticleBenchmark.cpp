@@ -0,0 +1,161 @@
+// Compares the per-object Particle::update path with the structure-of-arrays
+// integration kernels on the same number of particles, then shows how the
+// threaded ParticleSystem::update scales from one thread to all cores, and
+// times the emitter on a large burst.
+//
+// Usage: particle-bench [particleCount] [iterations]
+
+#include "../src/core/JobSystem.hpp"
+#include "../src/entities/Particle.hpp"
+#include "../src/systems/ParticleKernels.hpp"
+#include "../src/systems/ParticlePool.hpp"
+#include "../src/systems/ParticleSystem.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <thread>
+#include <string>
+#include <vector>
+
+namespace {
+    const float DeltaTime = 1.f / 144.f;
+    const float Lifetime = 1000.f;    // Long enough that nothing dies during the run
+    const int BurstSize = 10000;
+    
+    using BenchClock = std::chrono::steady_clock;
+    
+    double millisecondsSince(BenchClock::time_point start) {
+        return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+    }
+    
+    void report(const char* name, double totalMs, int iterations, double baselineMs) {
+        double perUpdate = totalMs / iterations;
+        std::printf("  %-22s %9.3f ms/update  %6.2fx\n", name, perUpdate, baselineMs / perUpdate);
+    }
+    
+    double benchmarkObjects(std::size_t count, int iterations) {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> dist(-100.f, 100.f);
+        
+        std::vector<std::unique_ptr<Particle>> particles;
+        particles.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            particles.push_back(std::make_unique<Particle>(sf::Vector2f(dist(rng), dist(rng)),
+                                                           sf::Vector2f(dist(rng), dist(rng)),
+                                                           Lifetime, 3.f));
+        }
+        
+        auto start = BenchClock::now();
+        for (int iteration = 0; iteration < iterations; ++iteration) {
+            for (auto& particle : particles) {
+                particle->update(DeltaTime);
+            }
+        }
+        return millisecondsSince(start);
+    }
+    
+    double benchmarkKernel(ParticleKernels::Backend backend, std::size_t count, int iterations) {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> dist(-100.f, 100.f);
+        
+        ParticlePool pool(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            pool.spawn(sf::Vector2f(dist(rng), dist(rng)), sf::Vector2f(dist(rng), dist(rng)),
+                       Lifetime, 3.f, sf::Color::White);
+        }
+        
+        ParticleKernels::setBackend(backend);
+        auto start = BenchClock::now();
+        for (int iteration = 0; iteration < iterations; ++iteration) {
+            ParticleKernels::integrate(pool.kernelArrays(), 0, pool.size(), DeltaTime);
+        }
+        return millisecondsSince(start);
+    }
+    
+    double benchmarkThreads(unsigned threadCount, std::size_t count, int iterations) {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> dist(-100.f, 100.f);
+        
+        JobSystem jobs(threadCount - 1);
+        ParticleSystem particles(count);
+        particles.setJobSystem(&jobs);
+        for (std::size_t i = 0; i < count; ++i) {
+            particles.emit(sf::Vector2f(dist(rng), dist(rng)), sf::Vector2f(dist(rng), dist(rng)),
+                           Lifetime, 3.f, sf::Color::White);
+        }
+        
+        auto start = BenchClock::now();
+        for (int iteration = 0; iteration < iterations; ++iteration) {
+            particles.update(DeltaTime);
+        }
+        return millisecondsSince(start);
+    }
+    
+    // Average time to spawn one burst into an empty pool
+    double benchmarkBurst(int burstSize, int iterations) {
+        ParticleSystem particles(static_cast<std::size_t>(burstSize));
+        double totalMs = 0.0;
+        for (int iteration = 0; iteration < iterations; ++iteration) {
+            particles.clear();
+            auto start = BenchClock::now();
+            particles.emitBurst(ParticleSystem::CollisionEmitter, sf::Vector2f(0.f, 0.f),
+                                sf::Vector2f(1.f, 0.f), burstSize);
+            totalMs += millisecondsSince(start);
+        }
+        return totalMs / iterations;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t count = argc > 1 ? static_cast<std::size_t>(std::atol(argv[1])) : 100000;
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 200;
+    
+    std::printf("Particle update, %zu particles, %d iterations\n", count, iterations);
+    
+    double objectMs = benchmarkObjects(count, iterations);
+    double baseline = objectMs / iterations;
+    report("Particle objects", objectMs, iterations, baseline);
+    
+    const ParticleKernels::Backend backends[] = {
+        ParticleKernels::Backend::Scalar,
+        ParticleKernels::Backend::SSE2,
+        ParticleKernels::Backend::AVX2
+    };
+    for (auto backend : backends) {
+        if (!ParticleKernels::isSupported(backend)) {
+            std::printf("  %-22s unsupported on this CPU\n", ParticleKernels::getBackendName(backend));
+            continue;
+        }
+        std::string name = std::string("SoA ") + ParticleKernels::getBackendName(backend);
+        report(name.c_str(), benchmarkKernel(backend, count, iterations), iterations, baseline);
+    }
+    
+    // Full ParticleSystem::update (best kernel, parallel blocks and compaction)
+    ParticleKernels::setBackend(ParticleKernels::Backend::AVX2);
+    unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("ParticleSystem::update scaling (%s kernel)\n",
+                ParticleKernels::getBackendName(ParticleKernels::getBackend()));
+    
+    // Powers of two up to the number of cores, and the core count itself
+    std::vector<unsigned> threadCounts;
+    for (unsigned threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+    
+    double singleThreadMs = 0.0;
+    for (unsigned threads : threadCounts) {
+        double totalMs = benchmarkThreads(threads, count, iterations);
+        if (threads == 1) singleThreadMs = totalMs / iterations;
+        std::string name = std::to_string(threads) + (threads == 1 ? " thread" : " threads");
+        report(name.c_str(), totalMs, iterations, singleThreadMs);
+    }
+    
+    double burstMs = benchmarkBurst(BurstSize, iterations);
+    std::printf("Emission: %d particle burst in %.1f us\n", BurstSize, burstMs * 1000.0);
+    
+    return 0;
+}
@@ -0,0 +1,103 @@
+// Plays a headless game through a series of shots, drawing every frame
+// through the game's counting render target (headless draws are counted, not
+// rendered), and reports draw calls, vertices and state switches per render
+// pass. Given a budget (the draw calls of a known-good build), exits with 1 if
+// any frame issued more, so a change that adds draw calls per frame shows up
+// as a failure.
+//
+// Usage: render-bench [drawCallBudget] [shots] [framesPerShot]   (budget 0: report only)
+
+#include "../src/core/Game.hpp"
+#include "../src/entities/Ball.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+namespace {
+    const float DeltaTime = 1.f / 144.f;
+    const int WarmupFrames = 288;       // Long enough to build the chunks around the spawn point
+    const float ShotLength = 80.f;      // Drag distance; short enough to stay in the built chunks
+    
+    using Pass = CountingRenderTarget::Pass;
+    
+    struct PassTotals {
+        std::uint64_t drawCalls = 0;
+        std::uint64_t vertices = 0;
+        std::uint64_t switches = 0;
+        std::uint32_t maxDrawCalls = 0;
+    };
+}
+
+int main(int argc, char* argv[]) {
+    unsigned budget = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1])) : 0;
+    int shots = argc > 2 ? std::atoi(argv[2]) : 10;
+    int framesPerShot = argc > 3 ? std::atoi(argv[3]) : 300;
+    
+    Game game(600, 600, true);
+    game.addEntity(std::make_unique<Ball>());
+    Ball* ball = game.findBall();
+    
+    for (int frame = 0; frame < WarmupFrames; ++frame) {
+        game.step(DeltaTime);
+    }
+    
+    std::array<PassTotals, CountingRenderTarget::PassCount> passes;
+    std::array<std::uint64_t, RenderPassStats::PrimitiveTypeCount> primitiveDraws{};
+    std::uint32_t maxDrawCalls = 0;
+    int framesOverBudget = 0;
+    int frames = 0;
+    
+    for (int shot = 0; shot < shots; ++shot) {
+        // Alternate left and right so the ball stays on the same stretch of course
+        sf::Vector2f position = ball->getPosition();
+        float pull = shot % 2 == 0 ? -ShotLength : ShotLength;
+        ball->handleMousePress(position);
+        ball->handleMouseRelease(position + sf::Vector2f(pull, 0.f));
+        
+        for (int frame = 0; frame < framesPerShot; ++frame) {
+            game.step(DeltaTime, true);
+            const CountingRenderTarget& stats = game.getRenderStats();
+            
+            for (std::size_t i = 0; i < CountingRenderTarget::PassCount; ++i) {
+                const RenderPassStats& pass = stats.getPassStats(static_cast<Pass>(i));
+                passes[i].drawCalls += pass.drawCalls;
+                passes[i].vertices += pass.vertices;
+                passes[i].switches += pass.textureSwitches + pass.stateSwitches;
+                passes[i].maxDrawCalls = std::max(passes[i].maxDrawCalls, pass.drawCalls);
+            }
+            
+            RenderPassStats totals = stats.getTotals();
+            for (std::size_t i = 0; i < RenderPassStats::PrimitiveTypeCount; ++i) {
+                primitiveDraws[i] += totals.primitiveDraws[i];
+            }
+            maxDrawCalls = std::max(maxDrawCalls, totals.drawCalls);
+            if (budget > 0 && totals.drawCalls > budget) framesOverBudget++;
+            frames++;
+        }
+    }
+    
+    std::printf("Drawn frames: %d (%d shots)\n", frames, shots);
+    std::printf("  %-12s %12s %10s %14s %12s\n", "pass", "draws/frame", "max draws", "vertices/frame", "switches");
+    for (std::size_t i = 0; i < CountingRenderTarget::PassCount; ++i) {
+        const PassTotals& pass = passes[i];
+        std::printf("  %-12s %12.1f %10u %14.1f %12.1f\n", CountingRenderTarget::getPassName(static_cast<Pass>(i)),
+                    static_cast<double>(pass.drawCalls) / frames, pass.maxDrawCalls,
+                    static_cast<double>(pass.vertices) / frames, static_cast<double>(pass.switches) / frames);
+    }
+    
+    std::printf("Draws per frame by primitive:");
+    for (std::size_t i = 0; i < RenderPassStats::PrimitiveTypeCount; ++i) {
+        if (primitiveDraws[i] == 0) continue;
+        std::printf(" %s %.1f", CountingRenderTarget::getPrimitiveName(static_cast<sf::PrimitiveType>(i)),
+                    static_cast<double>(primitiveDraws[i]) / frames);
+    }
+    std::printf("\nDraw calls: at most %u in one frame", maxDrawCalls);
+    if (budget > 0) {
+        std::printf(", budget %u, %d frames over budget", budget, framesOverBudget);
+    }
+    std::printf("\n");
+    
+    return framesOverBudget == 0 ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+// Captures a snapshot of a headless game before every shot, like the game does
+// for undo, and reports the capture time and the memory the snapshot history
+// holds. Then undoes every shot and checks that each restore puts the world
+// back exactly: the state captured right after a restore must match the
+// snapshot it was restored from. Exits with 1 if one doesn't.
+//
+// Usage: snapshot-bench [shots] [framesPerShot]
+
+#include "../src/core/Game.hpp"
+#include "../src/core/WorldSnapshot.hpp"
+#include "../src/entities/Ball.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+namespace {
+    const float DeltaTime = 1.f / 144.f;
+    const int WarmupFrames = 288;       // Long enough to build the chunks around the spawn point
+    const float ShotLength = 80.f;      // Drag distance; short enough to stay in the built chunks
+    
+    using BenchClock = std::chrono::steady_clock;
+    
+    double microsecondsSince(BenchClock::time_point start) {
+        return std::chrono::duration<double, std::micro>(BenchClock::now() - start).count();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int shots = argc > 1 ? std::atoi(argv[1]) : 20;
+    int framesPerShot = argc > 2 ? std::atoi(argv[2]) : 300;
+    
+    Game game(600, 600, true);
+    game.addEntity(std::make_unique<Ball>());
+    Ball* ball = game.findBall();
+    
+    for (int frame = 0; frame < WarmupFrames; ++frame) {
+        game.step(DeltaTime);
+    }
+    
+    // Play the shots, capturing before each one
+    const SnapshotHistory& history = game.getSnapshots();
+    double captureMicroseconds = 0.0;
+    float maxCaptureMicroseconds = 0.f;
+    std::size_t runs = 0;
+    std::size_t sharedRuns = 0;
+    for (int shot = 0; shot < shots; ++shot) {
+        const WorldSnapshot* previous = history.latest();
+        game.captureSnapshot();
+        const WorldSnapshot& snapshot = *history.latest();
+        captureMicroseconds += snapshot.captureMicroseconds;
+        maxCaptureMicroseconds = std::max(maxCaptureMicroseconds, snapshot.captureMicroseconds);
+        for (const WorldSnapshot::WallRun& run : snapshot.wallRuns) {
+            runs++;
+            if (previous && previous->findWalls(run.chunk, run.layout, run.walls->size()) == run.walls) sharedRuns++;
+        }
+        
+        // Alternate left and right so the ball stays on the same stretch of course
+        sf::Vector2f position = ball->getPosition();
+        float pull = shot % 2 == 0 ? -ShotLength : ShotLength;
+        ball->handleMousePress(position);
+        ball->handleMouseRelease(position + sf::Vector2f(pull, 0.f));
+        for (int frame = 0; frame < framesPerShot; ++frame) {
+            game.step(DeltaTime);
+        }
+    }
+    
+    std::printf("Captured %d snapshots (%zu kept)\n", shots, history.size());
+    std::printf("  capture  %8.2f us average, %.2f us max\n", captureMicroseconds / shots, maxCaptureMicroseconds);
+    std::printf("  walls    %zu runs, %zu shared with the previous snapshot\n", runs, sharedRuns);
+    std::printf("  memory   %.1f KB for %zu slots (%.1f KB tagged snapshots)\n", history.getByteSize() / 1024.0,
+                history.capacity(), Memory::getStats(Memory::Tag::Snapshots).liveBytes / 1024.0);
+    
+    // Undo every shot; the world right after a restore must be the snapshot's
+    int restores = 0;
+    int mismatches = 0;
+    double restoreMicroseconds = 0.0;
+    while (!history.empty()) {
+        WorldSnapshot expected = *history.latest();
+        
+        auto restoreStart = BenchClock::now();
+        game.undoShot();
+        restoreMicroseconds += microsecondsSince(restoreStart);
+        restores++;
+        
+        game.captureSnapshot();
+        if (!history.latest()->matches(expected)) mismatches++;
+        
+        // Drop the check's snapshot (restoring it changes nothing)
+        game.undoShot();
+    }
+    
+    std::printf("Undid %d shots: %.2f us per restore, %d mismatches\n", restores,
+                restores ? restoreMicroseconds / restores : 0.0, mismatches);
+    
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,52 @@
+#include "FrameGovernor.hpp"
+#include <algorithm>
+
+FrameGovernor::FrameGovernor(int levelCount, float targetFrameTime)
+    : levelCount(std::max(1, levelCount))
+    , level(this->levelCount - 1)
+    , targetFrameTime(targetFrameTime)
+    , averageFrameTime(targetFrameTime)
+    , slowFrames(0)
+    , fastFrames(0)
+    , levelChanges(0)
+{
+}
+
+bool FrameGovernor::update(float frameTime) {
+    float sample = std::min(frameTime, MaxFrameSample);
+    averageFrameTime += (sample - averageFrameTime) * Smoothing;
+    
+    // Count how long we've been on either side of the hysteresis band
+    if (averageFrameTime > targetFrameTime * DegradeRatio) {
+        slowFrames++;
+        fastFrames = 0;
+    } else if (averageFrameTime < targetFrameTime * RecoverRatio) {
+        fastFrames++;
+        slowFrames = 0;
+    } else {
+        slowFrames = 0;
+        fastFrames = 0;
+    }
+    
+    if (slowFrames >= DegradeFrames && level > 0) {
+        setLevel(level - 1);
+        return true;
+    }
+    if (fastFrames >= RecoverFrames && level < levelCount - 1) {
+        setLevel(level + 1);
+        return true;
+    }
+    return false;
+}
+
+void FrameGovernor::setLevel(int newLevel) {
+    newLevel = std::clamp(newLevel, 0, levelCount - 1);
+    if (newLevel != level) {
+        level = newLevel;
+        levelChanges++;
+    }
+    
+    // Each level gets a fresh window before the next decision
+    slowFrames = 0;
+    fastFrames = 0;
+}
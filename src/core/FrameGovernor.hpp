@@ -0,0 +1,49 @@
+#pragma once
+
+// Picks a quality level from measured frame times. Level 0 is the cheapest,
+// getLevelCount() - 1 is full quality. The level drops quickly when frames run
+// over the target and only climbs back after a sustained stretch of headroom,
+// so it doesn't oscillate around the threshold.
+class FrameGovernor {
+public:
+    FrameGovernor(int levelCount, float targetFrameTime);
+    
+    // Feed one frame's duration (seconds). Returns true if the level changed.
+    bool update(float frameTime);
+    
+    int getLevel() const { return level; }
+    int getLevelCount() const { return levelCount; }
+    void setLevel(int newLevel);
+    
+    float getTargetFrameTime() const { return targetFrameTime; }
+    void setTargetFrameTime(float target) { targetFrameTime = target; }
+    
+    // Smoothed frame time the decisions are based on
+    float getAverageFrameTime() const { return averageFrameTime; }
+    
+    // Number of level changes so far, for telemetry
+    unsigned getLevelChanges() const { return levelChanges; }
+    
+private:
+    // Weight of each new frame in the moving average
+    static constexpr float Smoothing = 0.1f;
+    
+    // Single hitches (loading, window drags) are clamped to this
+    static constexpr float MaxFrameSample = 0.1f;
+    
+    // Degrade above target * DegradeRatio, recover below target * RecoverRatio
+    static constexpr float DegradeRatio = 1.2f;
+    static constexpr float RecoverRatio = 1.05f;
+    
+    // Consecutive frames a condition must hold before the level moves
+    static const int DegradeFrames = 15;
+    static const int RecoverFrames = 240;
+    
+    int levelCount;
+    int level;
+    float targetFrameTime;
+    float averageFrameTime;
+    int slowFrames;
+    int fastFrames;
+    unsigned levelChanges;
+};
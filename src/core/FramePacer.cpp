@@ -0,0 +1,149 @@
+#include "FramePacer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace {
+    // Sleeps are taken in steps of this length, so each one can only overshoot a little
+    const std::chrono::milliseconds SleepStep(1);
+    
+    // Sleep estimate before any sleep has been measured
+    const double DefaultSleepSeconds = 0.002;
+    
+    // The sleep estimate averages over roughly this many recent sleeps
+    const std::uint64_t SleepWindow = 64;
+    
+    double toSeconds(FramePacer::Clock::duration duration) {
+        return std::chrono::duration<double>(duration).count();
+    }
+}
+
+FramePacer::FramePacer(float targetRate)
+    : targetRate(0.f)
+    , interval(Clock::duration::zero())
+    , scheduled(false)
+    , lastWait(0.f)
+    , sleepMean(DefaultSleepSeconds)
+    , sleepVariance(0.0)
+    , sleepCount(0)
+    , samples{}
+    , sampleCount(0)
+    , nextSample(0)
+    , missedFrames(0)
+{
+    setTargetRate(targetRate);
+}
+
+void FramePacer::setTargetRate(float rate) {
+    targetRate = std::max(rate, 0.f);
+    interval = targetRate > 0.f
+        ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / targetRate))
+        : Clock::duration::zero();
+    scheduled = false;
+}
+
+void FramePacer::wait() {
+    lastWait = 0.f;
+    if (interval > Clock::duration::zero()) {
+        Clock::time_point now = Clock::now();
+        if (!scheduled) {
+            deadline = now;
+            scheduled = true;
+        } else if (now > deadline + interval) {
+            // Too far behind to catch up without a burst of short frames
+            missedFrames++;
+            deadline = now;
+        } else {
+            sleepUntil(deadline);
+            lastWait = static_cast<float>(toSeconds(Clock::now() - now));
+        }
+        
+        // The next deadline is fixed relative to this one
+        deadline += interval;
+    }
+    
+    Clock::time_point now = Clock::now();
+    if (lastFrame != Clock::time_point()) {
+        addSample(std::chrono::duration<float, std::milli>(now - lastFrame).count());
+    }
+    lastFrame = now;
+}
+
+void FramePacer::resync() {
+    scheduled = false;
+    lastFrame = Clock::time_point();
+}
+
+void FramePacer::sleepUntil(Clock::time_point target) {
+    // Sleep while a step can't plausibly run past the deadline (mean plus one
+    // standard deviation of the measured step length)
+    while (true) {
+        double stdDeviation = std::sqrt(sleepVariance);
+        double remaining = toSeconds(target - Clock::now());
+        if (remaining <= sleepMean + stdDeviation) break;
+        
+        Clock::time_point start = Clock::now();
+        std::this_thread::sleep_for(SleepStep);
+        recordSleep(toSeconds(Clock::now() - start));
+    }
+    
+    // Spin out the rest, which is shorter than one sleep step
+    while (Clock::now() < target) {
+        std::this_thread::yield();
+    }
+}
+
+void FramePacer::recordSleep(double seconds) {
+    // Exponentially weighted, so the estimate follows changes in timer resolution
+    if (sleepCount < SleepWindow) sleepCount++;
+    double weight = 1.0 / sleepCount;
+    double delta = seconds - sleepMean;
+    sleepMean += weight * delta;
+    sleepVariance = (1.0 - weight) * (sleepVariance + weight * delta * delta);
+}
+
+void FramePacer::addSample(float milliseconds) {
+    samples[nextSample] = milliseconds;
+    nextSample = (nextSample + 1) % SampleCount;
+    sampleCount = std::min(sampleCount + 1, SampleCount);
+}
+
+FramePacingStats FramePacer::getStats() const {
+    FramePacingStats stats;
+    stats.frameCount = sampleCount;
+    stats.targetInterval = targetRate > 0.f ? 1000.f / targetRate : 0.f;
+    stats.missedFrames = missedFrames;
+    if (sampleCount == 0) return stats;
+    
+    double sum = 0.0;
+    double squares = 0.0;
+    for (std::size_t i = 0; i < sampleCount; ++i) {
+        sum += samples[i];
+        squares += static_cast<double>(samples[i]) * samples[i];
+        stats.maxInterval = std::max(stats.maxInterval, samples[i]);
+    }
+    double mean = sum / sampleCount;
+    stats.meanInterval = static_cast<float>(mean);
+    stats.stdDeviation = static_cast<float>(std::sqrt(std::max(0.0, squares / sampleCount - mean * mean)));
+    stats.p99Interval = getIntervalPercentile(0.99f);
+    
+    return stats;
+}
+
+float FramePacer::getIntervalPercentile(float fraction) const {
+    if (sampleCount == 0) return 0.f;
+    
+    // Nearest-rank percentile on a copy, leaving the ring buffer in order
+    std::array<float, SampleCount> sorted;
+    std::copy(samples.begin(), samples.begin() + sampleCount, sorted.begin());
+    double rankEstimate = std::ceil(std::clamp(static_cast<double>(fraction), 0.0, 1.0) * sampleCount);
+    std::size_t rank = std::max<std::size_t>(static_cast<std::size_t>(rankEstimate), 1) - 1;
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.begin() + sampleCount);
+    return sorted[rank];
+}
+
+void FramePacer::resetStats() {
+    sampleCount = 0;
+    nextSample = 0;
+    missedFrames = 0;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Frame-time statistics over the most recent frames, in milliseconds
+struct FramePacingStats {
+    std::size_t frameCount = 0;
+    float targetInterval = 0.f;     // 0 when the rate is unlimited
+    float meanInterval = 0.f;
+    float stdDeviation = 0.f;       // Jitter: spread of intervals around the mean
+    float p99Interval = 0.f;
+    float maxInterval = 0.f;
+    std::uint64_t missedFrames = 0; // Frames that started later than a full interval past their deadline
+};
+
+// Holds each frame back until its deadline on the steady clock. OS sleeps
+// overshoot by up to a scheduler tick, so the pacer sleeps in short steps
+// while there is comfortably more time left than a sleep tends to take,
+// then spins for the remainder. Deadlines advance by exactly one interval
+// from the previous deadline (not from when the wait ended), so rounding
+// doesn't accumulate into drift; after a long hitch the schedule restarts
+// instead of rushing frames out to catch up.
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    // A rate of 0 disables waiting (vsync or an uncapped frame rate); intervals are still measured
+    explicit FramePacer(float targetRate = 144.f);
+    
+    void setTargetRate(float rate);
+    float getTargetRate() const { return targetRate; }
+    
+    // Block until the next frame is due. Call once per frame, right before presenting.
+    void wait();
+    
+    // Seconds the last wait() spent holding the frame back
+    float getLastWaitTime() const { return lastWait; }
+    
+    // Start a new schedule after the loop stopped for a while (the gap isn't counted)
+    void resync();
+    
+    // Statistics over the last SampleCount frame intervals
+    FramePacingStats getStats() const;
+    void resetStats();
+    
+    // Interval (ms) that the given fraction of the recent frames came within (0 before any frame)
+    float getIntervalPercentile(float fraction) const;
+
+private:
+    static constexpr std::size_t SampleCount = 1024;
+    
+    // Sleep until shortly before deadline, then spin until it passes
+    void sleepUntil(Clock::time_point deadline);
+    
+    // Note how long a 1 ms sleep really took
+    void recordSleep(double seconds);
+    
+    void addSample(float milliseconds);
+    
+    float targetRate;
+    Clock::duration interval;
+    Clock::time_point deadline;
+    Clock::time_point lastFrame;
+    bool scheduled;
+    float lastWait;
+    
+    // Moving mean and variance of how long 1 ms sleeps actually take (seconds)
+    double sleepMean;
+    double sleepVariance;
+    std::uint64_t sleepCount;
+    
+    // Ring buffer of recent frame intervals
+    std::array<float, SampleCount> samples;
+    std::size_t sampleCount;
+    std::size_t nextSample;
+    std::uint64_t missedFrames;
+};
@@ -0,0 +1,44 @@
+#include "FrameProfiler.hpp"
+
+void FrameProfiler::beginFrame() {
+    current = Frame();
+    current.index = frameIndex;
+}
+
+void FrameProfiler::endFrame(float frameTime) {
+    current.frameTime = frameTime * 1000.f;
+    last = current;
+    frameIndex++;
+    
+    history[historyNext] = current.frameTime;
+    historyNext = (historyNext + 1) % HistoryLength;
+}
+
+const char* FrameProfiler::getSectionName(Section section) {
+    switch (section) {
+        case Section::Input: return "input";
+        case Section::Physics: return "physics";
+        case Section::Collision: return "collision";
+        case Section::Generation: return "generation";
+        case Section::Particles: return "particles";
+        case Section::Ghosts: return "ghosts";
+        case Section::Render: return "render";
+        default: return "unknown";
+    }
+}
+
+const char* FrameProfiler::getCounterName(Counter counter) {
+    switch (counter) {
+        case Counter::Entities: return "entities";
+        case Counter::Obstacles: return "obstacles";
+        case Counter::Particles: return "particles";
+        case Counter::DrawCalls: return "draw calls";
+        case Counter::Vertices: return "vertices";
+        case Counter::StateSwitches: return "state switches";
+        case Counter::Collisions: return "collisions";
+        case Counter::WallsBuilt: return "walls built";
+        case Counter::Allocations: return "allocations";
+        case Counter::Ghosts: return "ghosts";
+        default: return "unknown";
+    }
+}
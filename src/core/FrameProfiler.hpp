@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Per-frame timings of the game's systems and a few counts, plus a short
+// history of frame times. Sections are timed with Scope objects; the frame
+// that was just finished stays readable until the next one ends.
+class FrameProfiler {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    enum class Section {
+        Input,
+        Physics,
+        Collision,
+        Generation,
+        Particles,
+        Ghosts,
+        Render,
+        Count
+    };
+    
+    enum class Counter {
+        Entities,
+        Obstacles,
+        Particles,
+        DrawCalls,
+        Vertices,
+        StateSwitches,          // Texture, blend mode and shader changes between draws
+        Collisions,             // Collisions resolved
+        WallsBuilt,             // Obstacles generated
+        Allocations,            // Heap allocations seen by the memory tracker
+        Ghosts,                 // Ghost runs being played
+        Count
+    };
+    
+    static const std::size_t SectionCount = static_cast<std::size_t>(Section::Count);
+    static const std::size_t CounterCount = static_cast<std::size_t>(Counter::Count);
+    static const std::size_t HistoryLength = 120;
+    
+    struct Frame {
+        std::uint64_t index = 0;
+        float frameTime = 0.f;                                  // Milliseconds since the previous frame
+        std::array<float, SectionCount> sectionTimes{};         // Milliseconds
+        std::array<std::uint64_t, CounterCount> counters{};
+    };
+    
+    // Adds the time until it goes out of scope to a section
+    class Scope {
+    public:
+        Scope(FrameProfiler& profiler, Section section)
+            : profiler(profiler), section(section), start(Clock::now()) {}
+        ~Scope() {
+            profiler.addTime(section, std::chrono::duration<float, std::milli>(Clock::now() - start).count());
+        }
+        
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        FrameProfiler& profiler;
+        Section section;
+        Clock::time_point start;
+    };
+    
+    // Start collecting a new frame
+    void beginFrame();
+    
+    // Close the frame; frameTime is the frame's duration in seconds
+    void endFrame(float frameTime);
+    
+    void addTime(Section section, float milliseconds) {
+        current.sectionTimes[static_cast<std::size_t>(section)] += milliseconds;
+    }
+    
+    void setCounter(Counter counter, std::uint64_t value) {
+        current.counters[static_cast<std::size_t>(counter)] = value;
+    }
+    
+    // The last finished frame
+    const Frame& getLastFrame() const { return last; }
+    
+    // Frame times in milliseconds, oldest first via getHistoryStart()
+    const std::array<float, HistoryLength>& getHistory() const { return history; }
+    std::size_t getHistoryStart() const { return historyNext; }
+    
+    static const char* getSectionName(Section section);
+    static const char* getCounterName(Counter counter);
+
+private:
+    Frame current;
+    Frame last;
+    std::uint64_t frameIndex = 0;
+    std::array<float, HistoryLength> history{};
+    std::size_t historyNext = 0;
+};
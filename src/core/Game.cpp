@@ -1,16 +1,31 @@
 #include "Game.hpp"
+#include "JobSystem.hpp"
+#include "FrameGovernor.hpp"
+#include "LatencyTracker.hpp"
+#include "FramePacer.hpp"
+#include "FrameProfiler.hpp"
+#include "MetricsRecorder.hpp"
+#include "WorldSnapshot.hpp"
 #include "../entities/Ball.hpp"
 #include "../entities/Obstacle.hpp"
 #include "../systems/PhysicsSystem.hpp"
 #include "../systems/InputHandler.hpp"
+#include "../systems/EventDispatcher.hpp"
 #include "../systems/ObstacleGenerator.hpp"
 #include "../systems/ParticleSystem.hpp"
+#include "../systems/GhostSystem.hpp"
+#include "../systems/CourseFile.hpp"
+#include "../systems/PerformanceOverlay.hpp"
+#include "../utils/ResourceManager.hpp"
+#include "../utils/MemoryTracker.hpp"
+#include <algorithm>
 #include <random>
 #include <chrono>
 #include <vector>
 #include <cmath>
 #include <utility>
 #include <map>
+#include <filesystem>
 
 // Define standard aspect ratios
 const std::vector<std::pair<std::string, float>> STANDARD_RATIOS = {
@@ -30,13 +45,63 @@ const std::map<std::string, float> ZOOM_FACTORS = {
     {"32:9", 1.0f}
 };
 
-Game::Game(unsigned int width, unsigned int height)
-    : window(sf::VideoMode({width, height}), "Mini Golf", sf::Style::Default)
-    , originalSize(static_cast<float>(width), static_cast<float>(height))
+// Particle settings for each governor level, cheapest first
+const ParticleSystem::Quality PARTICLE_QUALITY[] = {
+    {0.25f, 0.5f, 4, 64},
+    {0.5f, 0.7f, 5, 128},
+    {0.75f, 0.85f, 6, 256},
+    {1.0f, 1.0f, 8, 1024}
+};
+
+const int QUALITY_LEVELS = sizeof(PARTICLE_QUALITY) / sizeof(PARTICLE_QUALITY[0]);
+
+// Assets listed here start loading in the background as soon as the game starts
+const std::string ASSET_MANIFEST = "assets/manifest.txt";
+
+// Packed assets, built from assets/ by the pack-assets target
+const std::string ASSET_ARCHIVE = "assets.pack";
+
+// Default frame rate
+const float FRAME_RATE = 144.f;
+
+// Scene render scales for each resolution level, lowest first
+const float RESOLUTION_SCALES[] = {0.5f, 0.625f, 0.75f, 0.875f, 1.f};
+
+const int RESOLUTION_LEVELS = sizeof(RESOLUTION_SCALES) / sizeof(RESOLUTION_SCALES[0]);
+
+// Work time per frame the resolution is tuned for, as a fraction of the frame interval
+const float RESOLUTION_HEADROOM = 0.85f;
+
+// With vsync, the display's refresh interval is taken as this percentile of the measured
+// frame intervals (no frame comes sooner; late frames take two or more), every so many seconds
+const float REFRESH_PERCENTILE = 0.1f;
+const float RETARGET_INTERVAL = 1.f;
+
+// Seconds the game must stay settled before the loop stops redrawing every frame
+const float IDLE_DELAY = 0.25f;
+
+Game::Game(unsigned int width, unsigned int height, bool headless)
+    : originalSize(static_cast<float>(width), static_cast<float>(height))
     , running(true)
+    , headless(headless)
     , tileSize(50.f)
+    , particleTimer(0.f)
+    , generationBudget(500.f)
+    , uploadBudget(1000.f)
+    , dynamicResolution(true)
+    , allocationCount(0)
+    , idleEnabled(true)
+    , idle(false)
+    , settledTime(0.f)
+    , verticalSync(false)
+    , busyTime(0.f)
+    , frameDeadline(1.f / FRAME_RATE)
+    , retargetTimer(0.f)
 {
-    window.setFramerateLimit(144);
+    // Headless games keep an unopened window, so events and views still work
+    if (!headless) {
+        window.create(sf::VideoMode({width, height}), "Mini Golf", sf::Style::Default);
+    }
     
     // Calculate window's aspect ratio
     float windowAspectRatio = static_cast<float>(width) / static_cast<float>(height);
@@ -74,11 +139,65 @@ Game::Game(unsigned int width, unsigned int height)
     // Initialize tile shape
     tileShape.setSize({tileSize, tileSize});
     
+    // Start decoding assets while the rest of the game initialises
+    ResourceManager::getInstance().mountArchive(ASSET_ARCHIVE);
+    if (std::filesystem::exists(ASSET_MANIFEST)) {
+        ResourceManager::getInstance().loadManifest(ASSET_MANIFEST);
+    }
+    
     // Initialize systems
+    jobSystem = std::make_unique<JobSystem>();
     physicsSystem = std::make_unique<PhysicsSystem>();
     inputHandler = std::make_unique<InputHandler>(window);
     obstacleGenerator = std::make_unique<ObstacleGenerator>();
+    obstacleGenerator->setFrameArena(&frameArena);
+    obstacleGenerator->setJobSystem(jobSystem.get());
     particleSystem = std::make_unique<ParticleSystem>();
+    particleSystem->setJobSystem(jobSystem.get());
+    ghostSystem = std::make_unique<GhostSystem>();
+    snapshots = std::make_unique<SnapshotHistory>();
+    
+    // Measure how long input takes to reach the screen
+    latencyTracker = std::make_unique<LatencyTracker>();
+    inputHandler->setLatencyTracker(latencyTracker.get());
+    
+    // Frame timings, shown on screen with F3
+    profiler = std::make_unique<FrameProfiler>();
+    performanceOverlay = std::make_unique<PerformanceOverlay>();
+    
+    // Window events
+    EventDispatcher& dispatcher = inputHandler->getDispatcher();
+    dispatcher.subscribe<sf::Event::Closed>([this](const sf::Event::Closed&) {
+        window.close();
+        running = false;
+        return true;
+    });
+    dispatcher.subscribe<sf::Event::Resized>([this](const sf::Event::Resized& resized) {
+        handleResize(resized.size.x, resized.size.y);
+        return true;
+    });
+    dispatcher.subscribe<sf::Event::KeyPressed>([this](const sf::Event::KeyPressed& key) {
+        if (key.code != sf::Keyboard::Key::F3) return false;
+        performanceOverlay->toggle();
+        return true;
+    });
+    dispatcher.subscribe<sf::Event::KeyPressed>([this](const sf::Event::KeyPressed& key) {
+        if (key.code != sf::Keyboard::Key::Z || !key.control) return false;
+        return undoShot();
+    });
+    
+    // Evenly spaced frames at the target rate
+    framePacer = std::make_unique<FramePacer>(FRAME_RATE);
+    
+    // Start at full quality, aiming for the frame rate
+    frameGovernor = std::make_unique<FrameGovernor>(QUALITY_LEVELS, 1.f / FRAME_RATE);
+    
+    // Render at full resolution until frames need more room
+    resolutionGovernor = std::make_unique<FrameGovernor>(RESOLUTION_LEVELS, RESOLUTION_HEADROOM / FRAME_RATE);
+    particleSystem->setQuality(PARTICLE_QUALITY[frameGovernor->getLevel()]);
+    
+    // Allocations counted per frame from here on
+    allocationCount = Memory::getTotalAllocations();
 }
 
 float Game::findClosestAspectRatio(float targetRatio) {
@@ -101,15 +220,117 @@ Game::~Game() {
 }
 
 void Game::run() {
+    // Validate and build the chunks around the ball up front, so the first frame doesn't wait for them
+    if (Ball* ball = findBall()) {
+        obstacleGenerator->scheduleChunks(ball->getPosition(), entities);
+        obstacleGenerator->generateObstacles(entities, generationBudget);
+    }
+    clock.restart();
+    framePacer->resync();
+    
     while (running && window.isOpen()) {
-        processEvents();
+        profiler->beginFrame();
+        busyClock.restart();
+        
+        if (idleEnabled && settledTime >= IDLE_DELAY) {
+            // Nothing is moving: sleep until input instead of redrawing the same frame.
+            // The time spent waiting isn't simulated.
+            idle = true;
+            inputHandler->waitEvents();
+            clock.restart();
+            busyClock.restart();
+            framePacer->resync();
+        } else {
+            FrameProfiler::Scope scope(*profiler, FrameProfiler::Section::Input);
+            processEvents();
+        }
         
         auto deltaTime = clock.restart().asSeconds();
         update(deltaTime);
         render();
+        finishFrame(deltaTime);
+        
+        // Everything allocated for this frame is done with
+        frameArena.reset();
+    }
+}
+
+void Game::step(float deltaTime, bool draw) {
+    profiler->beginFrame();
+    busyTime = deltaTime;   // Nothing is paced, the whole step counts as work
+    update(deltaTime);
+    if (draw) {
+        drawFrame();
+    }
+    finishFrame(deltaTime);
+    frameArena.reset();
+}
+
+void Game::finishFrame(float deltaTime) {
+    std::uint64_t allocations = Memory::getTotalAllocations();
+    profiler->setCounter(FrameProfiler::Counter::Allocations, allocations - allocationCount);
+    allocationCount = allocations;
+    
+    profiler->endFrame(deltaTime);
+    if (metrics) {
+        metrics->record(profiler->getLastFrame());
+    }
+}
+
+bool Game::recordMetrics(const std::string& filename) {
+    auto recorder = std::make_unique<MetricsRecorder>();
+    if (!recorder->open(filename)) {
+        return false;
+    }
+    
+    metrics = std::move(recorder);
+    return true;
+}
+
+void Game::setFrameRate(float rate, bool vsync) {
+    window.setVerticalSyncEnabled(vsync);
+    verticalSync = vsync;
+    framePacer->setTargetRate(rate);
+    
+    // Intervals measured before say nothing about the new pacing
+    framePacer->resetStats();
+    retargetTimer = 0.f;
+    retargetGovernors();
+    
+    // Frames that nothing paces have no deadline to trade quality for
+    if (!vsync && rate <= 0.f) {
+        frameGovernor->setLevel(QUALITY_LEVELS - 1);
+        particleSystem->setQuality(PARTICLE_QUALITY[frameGovernor->getLevel()]);
+        resolutionGovernor->setLevel(RESOLUTION_LEVELS - 1);
+    }
+}
+
+void Game::retargetGovernors() {
+    // The pacer's interval, or the display's refresh interval with vsync, whichever is longer
+    float rate = framePacer->getTargetRate();
+    frameDeadline = rate > 0.f ? 1.f / rate : 0.f;
+    if (verticalSync) {
+        frameDeadline = std::max(frameDeadline, framePacer->getIntervalPercentile(REFRESH_PERCENTILE) / 1000.f);
+    }
+    
+    // Left as they are until there is a deadline; the governors hold their level meanwhile
+    if (frameDeadline > 0.f) {
+        frameGovernor->setTargetFrameTime(frameDeadline);
+        resolutionGovernor->setTargetFrameTime(RESOLUTION_HEADROOM * frameDeadline);
+    }
+}
+
+void Game::setDynamicResolution(bool enabled) {
+    dynamicResolution = enabled;
+    if (!enabled) {
+        resolutionGovernor->setLevel(RESOLUTION_LEVELS - 1);
     }
 }
 
+float Game::getRenderScale() const {
+    return RESOLUTION_SCALES[resolutionGovernor->getLevel()];
+}
+
 void Game::addEntity(std::unique_ptr<Entity> entity) {
     // Special handling for Ball to set up collision callback
     if (auto ball = dynamic_cast<Ball*>(entity.get())) {
@@ -123,29 +344,70 @@ void Game::addEntity(std::unique_ptr<Entity> entity) {
             // Create green particles when the ball starts moving
             particleSystem->createMovementParticles(position, direction);
         });
+        
+        // Only the ball takes mouse input; presses must land on it to start a drag
+        EventDispatcher& dispatcher = inputHandler->getDispatcher();
+        dispatcher.subscribe<sf::Event::MouseButtonPressed>(
+            [this, ball](const sf::Event::MouseButtonPressed& pressed) {
+                if (pressed.button != sf::Mouse::Button::Left) return false;
+                return ball->handleMousePress(inputHandler->mapPixelToCoords(pressed.position));
+            },
+            [ball]() { return ball->getBounds(); });
+        dispatcher.subscribe<sf::Event::MouseButtonReleased>(
+            [this, ball](const sf::Event::MouseButtonReleased& released) {
+                // The world as it was before the shot, for undo
+                if (ball->isDragged()) {
+                    captureSnapshot();
+                }
+                return ball->handleMouseRelease(inputHandler->mapPixelToCoords(released.position));
+            });
+        dispatcher.subscribe<sf::Event::MouseMoved>(
+            [this, ball](const sf::Event::MouseMoved& moved) {
+                return ball->handleMouseMove(inputHandler->mapPixelToCoords(moved.position));
+            });
     }
     
     entities.push_back(std::move(entity));
 }
 
 void Game::processEvents() {
-    // Use our new InputHandler to process events
-    running = inputHandler->processEvents(entities);
-    
-    // Handle window resize (still needs to be in Game for now)
-    while (std::optional<sf::Event> event = window.pollEvent()) {
-        if (const auto* resized = event->getIf<sf::Event::Resized>()) {
-            handleResize(resized->size.x, resized->size.y);
-        }
-    }
+    // One pump for every event; handlers subscribed with the dispatcher
+    inputHandler->processEvents();
 }
 
 void Game::update(float deltaTime) {
+    // Hand assets decoded in the background to the GPU, a few per frame
+    ResourceManager::getInstance().processUploads(uploadBudget);
+    
+    // With vsync the display sets the frame interval; follow it as it is measured
+    if (!idle && verticalSync) {
+        retargetTimer += deltaTime;
+        if (retargetTimer >= RETARGET_INTERVAL) {
+            retargetTimer = 0.f;
+            retargetGovernors();
+        }
+    }
+    
+    // Trade particle detail, then render resolution, for time spent working on the last
+    // frame (up to presenting it). Frames drawn for input while idle say nothing about it.
+    if (!idle && frameDeadline > 0.f && frameGovernor->update(busyTime)) {
+        particleSystem->setQuality(PARTICLE_QUALITY[frameGovernor->getLevel()]);
+    }
+    if (!idle && frameDeadline > 0.f && dynamicResolution) {
+        resolutionGovernor->update(busyTime);
+    }
+    
     // Use the physics system for entity updates and collisions
-    physicsSystem->update(entities, deltaTime);
+    {
+        FrameProfiler::Scope scope(*profiler, FrameProfiler::Section::Physics);
+        physicsSystem->update(entities, deltaTime);
+    }
     
     // Update particle system
-    particleSystem->update(deltaTime);
+    {
+        FrameProfiler::Scope scope(*profiler, FrameProfiler::Section::Particles);
+        particleSystem->update(deltaTime);
+    }
     
     // Get the ball for obstacle generation and view centering
     Ball* ball = findBall();
@@ -153,14 +415,24 @@ void Game::update(float deltaTime) {
         // Get the ball's position
         sf::Vector2f ballPos = ball->getPosition();
         
-        // Generate new obstacles if needed
-        if (obstacleGenerator->shouldGenerateObstacles(ballPos)) {
-            auto obstacles = findObstacles();
-            obstacleGenerator->generateObstacles(ballPos, entities, obstacles);
+        // Queue new course chunks if needed, then build within this frame's budget
+        {
+            FrameProfiler::Scope scope(*profiler, FrameProfiler::Section::Generation);
+            if (obstacleGenerator->shouldGenerateObstacles(ballPos)) {
+                obstacleGenerator->scheduleChunks(ballPos, entities);
+            }
+            obstacleGenerator->generateObstacles(entities, generationBudget);
+            profiler->setCounter(FrameProfiler::Counter::WallsBuilt, obstacleGenerator->getStats().wallsThisFrame);
         }
         
         // Check for collisions
-        physicsSystem->checkCollisions(ball, findObstacles());
+        {
+            FrameProfiler::Scope scope(*profiler, FrameProfiler::Section::Collision);
+            FrameVector<Obstacle*> obstacles = findObstacles();
+            int collisions = physicsSystem->checkCollisions(ball, obstacles);
+            profiler->setCounter(FrameProfiler::Counter::Collisions, collisions);
+            profiler->setCounter(FrameProfiler::Counter::Obstacles, obstacles.size());
+        }
         
         // Center the view on the ball
         gameView.setCenter(ballPos);
@@ -174,39 +446,139 @@ void Game::update(float deltaTime) {
             sf::Vector2f direction = velocity / speed;
             
             // Generate trail particles (less frequent than collision particles)
-            static float particleTimer = 0.0f;
             particleTimer += deltaTime;
             if (particleTimer >= 0.01f) {  // Generate particles every 10ms
+                FrameProfiler::Scope scope(*profiler, FrameProfiler::Section::Particles);
                 particleSystem->createTrailParticles(ballPos, direction, speed);
                 particleTimer = 0.0f;
             }
         }
     }
+    
+    // Play the ghosts and record the ball's run
+    {
+        FrameProfiler::Scope scope(*profiler, FrameProfiler::Section::Ghosts);
+        ghostSystem->update(deltaTime);
+        if (ball) {
+            ghostSystem->record(ball->getPosition());
+        }
+        profiler->setCounter(FrameProfiler::Counter::Ghosts, ghostSystem->getStats().ghosts);
+    }
+    
+    profiler->setCounter(FrameProfiler::Counter::Entities, entities.size());
+    profiler->setCounter(FrameProfiler::Counter::Particles, particleSystem->getParticleCount());
+    
+    // Any activity ends idle mode straight away
+    if (isSettled()) {
+        settledTime += deltaTime;
+    } else {
+        settledTime = 0.f;
+        idle = false;
+    }
+}
+
+bool Game::isSettled() {
+    Ball* ball = findBall();
+    bool ballAtRest = !ball || ball->getVelocity() == sf::Vector2f(0.f, 0.f);
+    return ballAtRest && particleSystem->getParticleCount() == 0 && !ghostSystem->isPlaying() &&
+           !obstacleGenerator->hasPendingWork() &&
+           ResourceManager::getInstance().getPendingCount() == 0;
 }
 
 void Game::render() {
-    window.clear(); // Still clear the window to handle areas outside the view
+    drawFrame();
+    
+    // Work ends here; pacing and vsync only wait
+    busyTime = busyClock.getElapsedTime().asSeconds();
+    
+    // Hold the frame until its slot, so frames are presented at even intervals
+    framePacer->wait();
+    window.display();
+    
+    // Input consumed this frame is now on screen
+    latencyTracker->onFramePresented();
+}
+
+void Game::drawFrame() {
+    FrameProfiler::Scope scope(*profiler, FrameProfiler::Section::Render);
+    renderTarget.resetStats();
+    
+    // A headless game has nothing to draw to, its draws are only counted
+    sf::RenderTarget* screen = headless ? nullptr : &window;
+    renderTarget.setTarget(screen);
+    renderTarget.clear(); // Still clear the window to handle areas outside the view
+    
+    // The scene goes straight to the window at full resolution, otherwise into a
+    // smaller texture that is scaled up to fill the window
+    sf::Vector2u windowSize = window.getSize();
+    float scale = getRenderScale();
+    sf::Vector2u sceneSize(std::max(1u, static_cast<unsigned>(windowSize.x * scale)),
+                           std::max(1u, static_cast<unsigned>(windowSize.y * scale)));
+    bool downscaled = !headless && scale < 1.f;
+    if (downscaled && sceneTexture.getSize() != sceneSize) {
+        downscaled = sceneTexture.resize(sceneSize);
+        sceneTexture.setSmooth(true);
+    }
+    if (downscaled) {
+        renderTarget.setTarget(&sceneTexture);
+        renderTarget.clear();
+    }
     
     // Set view for drawing
-    window.setView(gameView);
+    renderTarget.setView(gameView);
     
     // Draw the tiled background
-    drawBackground();
+    renderTarget.beginPass(CountingRenderTarget::Pass::Background);
+    drawBackground(renderTarget);
     
     // First draw all shadows
+    renderTarget.beginPass(CountingRenderTarget::Pass::Shadows);
     for (auto& entity : entities) {
-        entity->drawShadow(window);
+        entity->drawShadow(renderTarget);
     }
     
     // Draw particles (between shadows and entities)
-    particleSystem->draw(window);
+    renderTarget.beginPass(CountingRenderTarget::Pass::Particles);
+    particleSystem->draw(renderTarget);
+    
+    // Ghost runs under the live ball
+    renderTarget.beginPass(CountingRenderTarget::Pass::Ghosts);
+    ghostSystem->draw(renderTarget);
     
     // Then draw all entities
+    renderTarget.beginPass(CountingRenderTarget::Pass::Entities);
     for (auto& entity : entities) {
-        entity->draw(window);
+        entity->draw(renderTarget);
     }
     
-    window.display();
+    if (downscaled) {
+        // Upscale the scene to cover the window with a single textured quad
+        sceneTexture.display();
+        renderTarget.setTarget(&window);
+        renderTarget.beginPass(CountingRenderTarget::Pass::Upscale);
+        sf::Sprite upscaled(sceneTexture.getTexture());
+        upscaled.setScale({static_cast<float>(windowSize.x) / sceneSize.x,
+                           static_cast<float>(windowSize.y) / sceneSize.y});
+        renderTarget.setView(sf::View(sf::FloatRect({0.f, 0.f}, sf::Vector2f(windowSize))));
+        renderTarget.draw(upscaled);
+        renderTarget.setView(gameView);
+    }
+    
+    // Overlays stay at native resolution
+    renderTarget.beginPass(CountingRenderTarget::Pass::Overlays);
+    for (auto& entity : entities) {
+        entity->drawOverlay(renderTarget);
+    }
+    
+    // Timings of the previous frame, on top of everything
+    renderTarget.beginPass(CountingRenderTarget::Pass::Hud);
+    performanceOverlay->update(*profiler, frameGovernor->getTargetFrameTime());
+    performanceOverlay->draw(renderTarget);
+    
+    RenderPassStats totals = renderTarget.getTotals();
+    profiler->setCounter(FrameProfiler::Counter::DrawCalls, totals.drawCalls);
+    profiler->setCounter(FrameProfiler::Counter::Vertices, totals.vertices);
+    profiler->setCounter(FrameProfiler::Counter::StateSwitches, totals.textureSwitches + totals.stateSwitches);
 }
 
 void Game::handleResize(unsigned int width, unsigned int height) {
@@ -266,8 +638,185 @@ Ball* Game::findBall() {
     return nullptr;
 }
 
-std::vector<Obstacle*> Game::findObstacles() {
-    std::vector<Obstacle*> obstacles;
+bool Game::saveCourse(const std::string& filename, int chunkCount) {
+    // Collect the chunks as they appear in the current course
+    std::vector<CourseChunk> chunks;
+    chunks.reserve(chunkCount);
+    for (int chunk = 0; chunk < chunkCount; ++chunk) {
+        chunks.push_back(obstacleGenerator->chunkAt(chunk));
+    }
+    
+    return CourseFile::save(filename, obstacleGenerator->getSeed(), std::move(chunks));
+}
+
+bool Game::loadCourse(const std::string& filename) {
+    auto course = std::make_unique<CourseFile>();
+    if (!course->open(filename)) {
+        return false;
+    }
+    
+    // Drop the current walls; the new generator rebuilds them from the file
+    obstacleGenerator->clearChunks(entities);
+    
+    // Chunks missing from the file continue procedurally from its seed
+    obstacleGenerator = std::make_unique<ObstacleGenerator>(course->getSeed());
+    obstacleGenerator->setCourse(course.get());
+    obstacleGenerator->setFrameArena(&frameArena);
+    obstacleGenerator->setJobSystem(jobSystem.get());
+    loadedCourse = std::move(course);
+    
+    // A new course starts a new run; earlier shots can't be undone into it
+    ghostSystem->restart();
+    snapshots->clear();
+    
+    return true;
+}
+
+bool Game::saveGhost(const std::string& filename) const {
+    return ghostSystem->getRecording().save(filename);
+}
+
+bool Game::loadGhost(const std::string& filename) {
+    GhostTrack track;
+    if (!track.load(filename)) {
+        return false;
+    }
+    return ghostSystem->addGhost(std::move(track));
+}
+
+void Game::captureSnapshot() {
+    auto start = std::chrono::steady_clock::now();
+    
+    // Chunks unchanged since the previous snapshot share its wall blocks
+    const WorldSnapshot* previous = snapshots->latest();
+    WorldSnapshot& snapshot = snapshots->push();
+    
+    Ball* ball = findBall();
+    snapshot.hasBall = ball != nullptr;
+    if (ball) {
+        snapshot.ball = ball->getState();
+    }
+    
+    // Walls in entity order, one run per chunk
+    FrameVector<Obstacle*> obstacles = findObstacles();
+    snapshot.wallRuns.clear();
+    for (std::size_t begin = 0; begin < obstacles.size();) {
+        int chunk = obstacles[begin]->getChunk();
+        std::size_t end = begin + 1;
+        while (end < obstacles.size() && obstacles[end]->getChunk() == chunk) {
+            end++;
+        }
+        
+        int layout = obstacleGenerator->getBuiltLayout(chunk);
+        std::shared_ptr<const WorldSnapshot::WallBlock> walls;
+        if (previous && chunk != ObstacleGenerator::NoChunk && layout != ObstacleGenerator::NoLayout) {
+            walls = previous->findWalls(chunk, layout, end - begin);
+        }
+        if (!walls) {
+            auto block = std::allocate_shared<WorldSnapshot::WallBlock>(
+                Memory::TaggedAllocator<WorldSnapshot::WallBlock, Memory::Tag::Snapshots>());
+            block->reserve(end - begin);
+            for (std::size_t i = begin; i < end; ++i) {
+                const Obstacle& obstacle = *obstacles[i];
+                block->push_back({obstacle.getPosition(), obstacle.getSize(), obstacle.getRotation(), obstacle.getColor()});
+            }
+            walls = std::move(block);
+        }
+        snapshot.wallRuns.push_back({chunk, layout, std::move(walls)});
+        begin = end;
+    }
+    
+    obstacleGenerator->saveState(snapshot.generator);
+    particleSystem->saveState(snapshot.particles);
+    snapshot.particleTimer = particleTimer;
+    snapshot.ghosts = ghostSystem->getState();
+    
+    snapshot.captureMicroseconds = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool Game::undoShot(std::size_t shots) {
+    if (shots == 0 || shots > snapshots->size()) {
+        return false;
+    }
+    
+    for (std::size_t i = 1; i < shots; ++i) {
+        snapshots->pop();
+    }
+    restoreSnapshot(*snapshots->latest());
+    snapshots->pop();
+    return true;
+}
+
+void Game::restoreSnapshot(const WorldSnapshot& snapshot) {
+    // Take the walls out, keeping the other entities in order
+    FrameVector<std::unique_ptr<Entity>> walls(&frameArena);
+    walls.reserve(entities.size());
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < entities.size(); ++i) {
+        if (dynamic_cast<Obstacle*>(entities[i].get())) {
+            walls.push_back(std::move(entities[i]));
+            continue;
+        }
+        if (kept != i) {
+            entities[kept] = std::move(entities[i]);
+        }
+        kept++;
+    }
+    entities.resize(kept);
+    
+    // Put the walls back in their saved order, after the other entities. A chunk that
+    // still has the snapshot's layout and wall count keeps its obstacles; only the
+    // chunks that differ are rebuilt.
+    for (const WorldSnapshot::WallRun& run : snapshot.wallRuns) {
+        std::size_t begin = walls.size();
+        if (run.chunk != ObstacleGenerator::NoChunk && run.layout != ObstacleGenerator::NoLayout &&
+            run.layout == obstacleGenerator->getBuiltLayout(run.chunk)) {
+            for (begin = 0; begin < walls.size(); ++begin) {
+                if (walls[begin] && static_cast<Obstacle*>(walls[begin].get())->getChunk() == run.chunk) break;
+            }
+        }
+        
+        std::size_t end = begin;
+        while (end < walls.size() && walls[end] && static_cast<Obstacle*>(walls[end].get())->getChunk() == run.chunk) {
+            end++;
+        }
+        
+        if (end - begin == run.walls->size()) {
+            for (std::size_t i = begin; i < end; ++i) {
+                entities.push_back(std::move(walls[i]));
+            }
+            continue;
+        }
+        
+        for (const WallSpec& wall : *run.walls) {
+            auto obstacle = std::make_unique<Obstacle>(wall.position, wall.size, wall.color);
+            obstacle->setRotation(wall.rotation);
+            obstacle->setChunk(run.chunk);
+            entities.push_back(std::move(obstacle));
+        }
+    }
+    
+    obstacleGenerator->restoreState(snapshot.generator);
+    particleSystem->restoreState(snapshot.particles);
+    particleTimer = snapshot.particleTimer;
+    ghostSystem->setState(snapshot.ghosts);
+    
+    Ball* ball = findBall();
+    if (ball && snapshot.hasBall) {
+        ball->setState(snapshot.ball);
+        gameView.setCenter(snapshot.ball.position);
+        window.setView(gameView);
+    }
+    
+    // Show the restored world straight away
+    settledTime = 0.f;
+    idle = false;
+}
+
+FrameVector<Obstacle*> Game::findObstacles() {
+    // Sized for the worst case up front; growing would leave dead copies in the arena
+    FrameVector<Obstacle*> obstacles(&frameArena);
+    obstacles.reserve(entities.size());
     for (auto& entity : entities) {
         Obstacle* obstacle = dynamic_cast<Obstacle*>(entity.get());
         if (obstacle) obstacles.push_back(obstacle);
@@ -275,7 +824,7 @@ std::vector<Obstacle*> Game::findObstacles() {
     return obstacles;
 }
 
-void Game::drawBackground() {
+void Game::drawBackground(CountingRenderTarget& target) {
     // Get the view bounds
     sf::Vector2f viewCenter = gameView.getCenter();
     sf::Vector2f viewSize = gameView.getSize();
@@ -304,7 +853,7 @@ void Game::drawBackground() {
             tileShape.setPosition(sf::Vector2f(col * tileSize, row * tileSize));
             
             // Draw the tile
-            window.draw(tileShape);
+            target.draw(tileShape);
         }
     }
 } 
\ No newline at end of file
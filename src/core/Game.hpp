@@ -6,8 +6,11 @@
 #include <typeindex>
 #include <typeinfo>
 #include <random>
+#include <string>
 #include "../utils/Entity.hpp"
 #include "../utils/Colors.hpp"
+#include "../utils/FrameArena.hpp"
+#include "../utils/CountingRenderTarget.hpp"
 
 // Forward declarations
 class Ball;
@@ -16,45 +19,196 @@ class PhysicsSystem;
 class InputHandler;
 class ObstacleGenerator;
 class ParticleSystem;
+class CourseFile;
+class JobSystem;
+class FrameGovernor;
+class LatencyTracker;
+class FramePacer;
+class FrameProfiler;
+class MetricsRecorder;
+class PerformanceOverlay;
+class GhostSystem;
+class SnapshotHistory;
+struct WorldSnapshot;
 
 class Game {
 public:
-    Game(unsigned int width = 600, unsigned int height = 600);
+    // A headless game has no window; drive it with step() (benchmarks and tools)
+    Game(unsigned int width = 600, unsigned int height = 600, bool headless = false);
     ~Game();
     
     void run();
+    
+    // Advance the game by one frame without processing events or presenting. With draw, the
+    // frame's draws are also made; a headless game only counts them (see getRenderStats).
+    void step(float deltaTime, bool draw = false);
+    
     void addEntity(std::unique_ptr<Entity> entity);
     
     // Entity access methods
     Ball* findBall();
-    std::vector<Obstacle*> findObstacles();
+    
+    // Obstacles currently in the world, valid until the end of the frame
+    FrameVector<Obstacle*> findObstacles();
+    
+    // Save the first chunkCount chunks of the current course to a binary course file
+    bool saveCourse(const std::string& filename, int chunkCount = 32);
+    
+    // Replace the current course with one loaded from a course file
+    bool loadCourse(const std::string& filename);
+    
+    // Save the ball's run so far as a ghost file
+    bool saveGhost(const std::string& filename) const;
+    
+    // Play a ghost file alongside the ball (ghosts line up with the course they were recorded on)
+    bool loadGhost(const std::string& filename);
+    
+    // Ghost runs, the ball's recording and playback costs
+    GhostSystem& getGhosts() { return *ghostSystem; }
+    
+    // Save the whole simulation: ball, walls, generation progress and particles.
+    // One is captured before every shot.
+    void captureSnapshot();
+    
+    // Put the world back as it was before the last shots (false if there aren't that many
+    // snapshots). Ctrl+Z undoes one shot.
+    bool undoShot(std::size_t shots = 1);
+    
+    // Snapshots kept for undo, with their memory and capture times
+    const SnapshotHistory& getSnapshots() const { return *snapshots; }
+    
+    // Frames per second to pace the loop to (0 for no limit), optionally with vsync.
+    // With vsync on, the display paces frames and the rate only caps below its refresh rate;
+    // the quality governors aim at the measured refresh interval. With neither, they stay
+    // at full quality.
+    void setFrameRate(float rate, bool vsync = false);
+    
+    // Render the scene at a lower resolution when frames take too long, scaling it up
+    // to the window (overlays stay at native resolution). On by default.
+    void setDynamicResolution(bool enabled);
+    
+    // Fraction of the window resolution the scene is rendered at
+    float getRenderScale() const;
+    
+    // Frame interval and jitter statistics
+    const FramePacer& getFramePacer() const { return *framePacer; }
+    
+    // Quality level chosen from frame times (for telemetry)
+    const FrameGovernor& getFrameGovernor() const { return *frameGovernor; }
+    
+    // Input-to-photon latency histograms
+    LatencyTracker& getLatencyTracker() { return *latencyTracker; }
+    
+    // Per-system timings and counts of the last frame (F3 shows them on screen)
+    const FrameProfiler& getProfiler() const { return *profiler; }
+    
+    // Write every frame's timings and counts to filename (.csv, .jsonl, otherwise binary)
+    bool recordMetrics(const std::string& filename);
+    
+    // Recorded frames and their summary (nullptr until recordMetrics is called)
+    const MetricsRecorder* getMetrics() const { return metrics.get(); }
+    
+    // Draw calls, vertices and state switches of the last drawn frame, per render pass
+    const CountingRenderTarget& getRenderStats() const { return renderTarget; }
+    
+    // At rest (ball stopped, no particles, nothing loading) the window only redraws
+    // on input instead of every frame. On by default.
+    void setIdleEnabled(bool enabled) { idleEnabled = enabled; }
+    bool isIdle() const { return idle; }
+    
+    // Scratch memory released at the end of every frame
+    const FrameArena& getFrameArena() const { return frameArena; }
     
 private:
     void processEvents();
     void update(float deltaTime);
     void render();
+    
+    // Make the frame's draws (render() also presents it)
+    void drawFrame();
+    
+    // Close the frame's profile and hand it to the metrics recorder
+    void finishFrame(float deltaTime);
+    
+    // Point the quality governors at the current frame interval
+    void retargetGovernors();
     void handleResize(unsigned int width, unsigned int height);
-    void drawBackground();
+    void drawBackground(CountingRenderTarget& target);
+    
+    // Replace the simulation state with a snapshot's
+    void restoreSnapshot(const WorldSnapshot& snapshot);
+    
+    // True when another frame would look exactly like the last one
+    bool isSettled();
     
     // Helper method to find the closest standard aspect ratio
     float findClosestAspectRatio(float targetRatio);
     
     // Systems
+    std::unique_ptr<JobSystem> jobSystem;
     std::unique_ptr<PhysicsSystem> physicsSystem;
     std::unique_ptr<InputHandler> inputHandler;
     std::unique_ptr<ObstacleGenerator> obstacleGenerator;
     std::unique_ptr<ParticleSystem> particleSystem;
+    std::unique_ptr<GhostSystem> ghostSystem;
+    std::unique_ptr<FrameGovernor> frameGovernor;
+    std::unique_ptr<FrameGovernor> resolutionGovernor;
+    std::unique_ptr<LatencyTracker> latencyTracker;
+    std::unique_ptr<FramePacer> framePacer;
+    std::unique_ptr<FrameProfiler> profiler;
+    std::unique_ptr<PerformanceOverlay> performanceOverlay;
+    std::unique_ptr<MetricsRecorder> metrics;
+    std::unique_ptr<SnapshotHistory> snapshots;
+    
+    // Course file backing the obstacle generator (if one was loaded)
+    std::unique_ptr<CourseFile> loadedCourse;
+    
+    // Transient per-frame allocations (obstacle lists, path scratch)
+    FrameArena frameArena;
     
     sf::RenderWindow window;
+    sf::RenderTexture sceneTexture;     // Scene target when rendering below native resolution
+    CountingRenderTarget renderTarget;  // Every draw goes through it to be counted
     sf::View gameView;
     sf::Vector2f originalSize;
     sf::Vector2f gameViewSize;  // Stores the aspect ratio view dimensions
     sf::Clock clock;
     std::vector<std::unique_ptr<Entity>> entities;
     bool running;
+    bool headless;
     
     // Background tiles
     sf::RectangleShape tileShape;
     float tileSize;
     float closestRatio;
+    
+    // Time since the last trail particles were emitted
+    float particleTimer;
+    
+    // Microseconds of obstacle generation allowed per frame (a 144 Hz frame is ~6900)
+    float generationBudget;
+    
+    // Microseconds of resource uploads (decoded off-thread) allowed per frame
+    float uploadBudget;
+    
+    bool dynamicResolution;
+    
+    // Tracked allocation count at the end of the previous frame
+    std::uint64_t allocationCount;
+    
+    // Idle mode: the loop waits for events once the game has been settled for a moment
+    bool idleEnabled;
+    bool idle;
+    float settledTime;
+    
+    // Frame pacing as set by setFrameRate, and seconds spent working on the last frame
+    // (before waiting to present it), which the governors are fed
+    bool verticalSync;
+    sf::Clock busyClock;
+    float busyTime;
+    
+    // Frame interval the governors aim at (0 while unknown or unpaced), retargeted
+    // every RETARGET_INTERVAL with vsync
+    float frameDeadline;
+    float retargetTimer;
 }; 
\ No newline at end of file
@@ -0,0 +1,181 @@
+#include "JobSystem.hpp"
+#include <algorithm>
+
+namespace {
+    // Queue owned by the current thread; threads that aren't workers use queue 0
+    thread_local unsigned currentQueue = 0;
+}
+
+bool JobSystem::TaskQueue::pushBack(const Task& task) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (size == Capacity) return false;
+    tasks[(head + size) % Capacity] = task;
+    size++;
+    return true;
+}
+
+bool JobSystem::TaskQueue::popBack(Task& task) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (size == 0) return false;
+    size--;
+    task = tasks[(head + size) % Capacity];
+    return true;
+}
+
+bool JobSystem::TaskQueue::popFront(Task& task) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (size == 0) return false;
+    task = tasks[head];
+    head = (head + 1) % Capacity;
+    size--;
+    return true;
+}
+
+JobSystem::JobSystem(unsigned workerCount)
+    : queuedTasks(0)
+    , stopping(false)
+{
+    for (unsigned i = 0; i <= workerCount; ++i) {
+        queues.push_back(std::make_unique<TaskQueue>());
+    }
+    
+    for (unsigned i = 1; i <= workerCount; ++i) {
+        workers.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+    
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+unsigned JobSystem::defaultWorkerCount() {
+    unsigned hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+}
+
+void JobSystem::run(std::size_t count, std::size_t grainSize, RangeFunction function, void* context) {
+    if (count == 0) return;
+    grainSize = std::max<std::size_t>(grainSize, 1);
+    
+    // Nothing to share: run inline
+    if (workers.empty() || count <= grainSize) {
+        function(context, 0, count);
+        return;
+    }
+    
+    std::size_t taskCount = (count + grainSize - 1) / grainSize;
+    Batch batch;
+    batch.remaining.store(taskCount, std::memory_order_relaxed);
+    batch.failed.store(false, std::memory_order_relaxed);
+    
+    // Deal the ranges out round-robin, starting with our own queue
+    unsigned ownQueue = currentQueue;
+    for (std::size_t i = 0; i < taskCount; ++i) {
+        Task task = {function, context, i * grainSize, std::min(count, (i + 1) * grainSize), &batch};
+        TaskQueue& queue = *queues[(ownQueue + i) % queues.size()];
+        
+        if (queue.pushBack(task)) {
+            queuedTasks.fetch_add(1, std::memory_order_release);
+        } else {
+            execute(task);    // Queue full, do it ourselves
+        }
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wakeCondition.notify_all();
+    
+    // Help until every range of this call is done (also runs other callers' tasks)
+    Task task;
+    while (batch.remaining.load(std::memory_order_acquire) > 0) {
+        if (findTask(ownQueue, task)) {
+            execute(task);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    
+    if (batch.error) {
+        std::rethrow_exception(batch.error);
+    }
+}
+
+void JobSystem::submitTask(RangeFunction function, void* context) {
+    Task task = {function, context, 0, 0, nullptr};
+    if (!backgroundQueue.pushBack(task)) {
+        execute(task);    // Queue full, do it ourselves
+        return;
+    }
+    queuedTasks.fetch_add(1, std::memory_order_release);
+    
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wakeCondition.notify_one();
+}
+
+void JobSystem::workerLoop(unsigned queueIndex) {
+    currentQueue = queueIndex;
+    
+    Task task;
+    while (true) {
+        // parallelFor ranges first, someone is waiting for them
+        if (findTask(queueIndex, task)) {
+            execute(task);
+            continue;
+        }
+        if (backgroundQueue.popFront(task)) {
+            queuedTasks.fetch_sub(1, std::memory_order_acq_rel);
+            execute(task);
+            continue;
+        }
+        
+        // Sleep until new tasks are queued; when stopping, only once every task has run
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeCondition.wait(lock, [this]() {
+            return stopping || queuedTasks.load(std::memory_order_acquire) > 0;
+        });
+        if (stopping && queuedTasks.load(std::memory_order_acquire) == 0) return;
+    }
+}
+
+bool JobSystem::findTask(unsigned queueIndex, Task& task) {
+    bool found = queues[queueIndex]->popBack(task);
+    
+    // Steal the oldest task of another thread
+    for (std::size_t i = 1; !found && i < queues.size(); ++i) {
+        found = queues[(queueIndex + i) % queues.size()]->popFront(task);
+    }
+    
+    if (found) {
+        queuedTasks.fetch_sub(1, std::memory_order_acq_rel);
+    }
+    return found;
+}
+
+void JobSystem::execute(const Task& task) {
+    // Submitted jobs have nobody waiting for them
+    if (!task.batch) {
+        task.function(task.context, task.begin, task.end);
+        return;
+    }
+    
+    // A throwing range must still count as done, or its caller would wait forever
+    try {
+        task.function(task.context, task.begin, task.end);
+    } catch (...) {
+        if (!task.batch->failed.exchange(true, std::memory_order_acq_rel)) {
+            task.batch->error = std::current_exception();
+        }
+    }
+    task.batch->remaining.fetch_sub(1, std::memory_order_acq_rel);
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Work-stealing job system. Every thread (workers plus the thread calling
+// parallelFor) owns a bounded task queue: owners take work from the back,
+// idle threads steal from the front of other queues. The calling thread
+// works on its own jobs until they are done, so parallelFor is synchronous.
+// Longer background jobs can be submitted to a separate queue that only the
+// workers take from.
+class JobSystem {
+public:
+    // workerCount threads are started in addition to the calling thread
+    explicit JobSystem(unsigned workerCount = defaultWorkerCount());
+    ~JobSystem();
+    
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+    
+    // Call body(begin, end) on sub-ranges of [0, count) of at most grainSize items.
+    // If a range throws, the other ranges still run and the first exception is
+    // rethrown on the calling thread.
+    template <typename Function>
+    void parallelFor(std::size_t count, std::size_t grainSize, Function&& body) {
+        using Body = std::remove_reference_t<Function>;
+        auto invoke = [](void* context, std::size_t begin, std::size_t end) {
+            (*static_cast<Body*>(context))(begin, end);
+        };
+        run(count, grainSize, invoke, const_cast<void*>(static_cast<const void*>(&body)));
+    }
+    
+    // Run job() once on a worker and return without waiting for it. Jobs only
+    // run on workers, never on a thread helping out in parallelFor, so a long
+    // job can't stall the caller of a parallelFor. Without workers the job runs
+    // right away on the calling thread. Jobs must not throw; jobs still queued
+    // when the job system is destroyed are run first.
+    template <typename Function>
+    void submit(Function&& job) {
+        using Job = std::decay_t<Function>;
+        if (workers.empty()) {
+            job();
+            return;
+        }
+        auto invoke = [](void* context, std::size_t, std::size_t) {
+            std::unique_ptr<Job> owned(static_cast<Job*>(context));
+            (*owned)();
+        };
+        submitTask(invoke, new Job(std::forward<Function>(job)));
+    }
+    
+    unsigned getWorkerCount() const { return static_cast<unsigned>(workers.size()); }
+    unsigned getThreadCount() const { return getWorkerCount() + 1; }
+    
+    // One worker per hardware thread, leaving one for the main thread
+    static unsigned defaultWorkerCount();
+    
+private:
+    using RangeFunction = void (*)(void* context, std::size_t begin, std::size_t end);
+    
+    // Completion state of one parallelFor call
+    struct Batch {
+        std::atomic<std::size_t> remaining;     // Tasks left to finish
+        std::atomic<bool> failed;
+        std::exception_ptr error;               // First exception thrown, written once by whoever sets failed
+    };
+    
+    struct Task {
+        RangeFunction function;
+        void* context;
+        std::size_t begin;
+        std::size_t end;
+        Batch* batch;                           // The parallelFor this belongs to (nullptr for submitted jobs)
+    };
+    
+    // Bounded deque protected by a mutex; never allocates after construction
+    struct TaskQueue {
+        static const std::size_t Capacity = 1024;
+        
+        bool pushBack(const Task& task);
+        bool popBack(Task& task);
+        bool popFront(Task& task);
+        
+        std::mutex mutex;
+        Task tasks[Capacity];
+        std::size_t head = 0;
+        std::size_t size = 0;
+    };
+    
+    void run(std::size_t count, std::size_t grainSize, RangeFunction function, void* context);
+    void submitTask(RangeFunction function, void* context);
+    void workerLoop(unsigned queueIndex);
+    
+    // Take a task from our own queue, or steal one from another thread
+    bool findTask(unsigned queueIndex, Task& task);
+    void execute(const Task& task);
+    
+    std::vector<std::unique_ptr<TaskQueue>> queues;   // Index 0 belongs to outside threads
+    TaskQueue backgroundQueue;                         // Submitted jobs, taken by workers only
+    std::vector<std::thread> workers;
+    
+    std::mutex sleepMutex;
+    std::condition_variable wakeCondition;
+    std::atomic<std::size_t> queuedTasks;
+    bool stopping;
+};
@@ -0,0 +1,130 @@
+#include "LatencyTracker.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+void LatencyHistogram::add(float milliseconds) {
+    std::size_t bucket = static_cast<std::size_t>(std::max(0.f, milliseconds) / BucketWidth);
+    buckets[std::min(bucket, BucketCount - 1)]++;
+    
+    minimum = count ? std::min(minimum, milliseconds) : milliseconds;
+    maximum = std::max(maximum, milliseconds);
+    sum += milliseconds;
+    count++;
+}
+
+void LatencyHistogram::clear() {
+    buckets.fill(0);
+    count = 0;
+    sum = 0.0;
+    minimum = 0.f;
+    maximum = 0.f;
+}
+
+float LatencyHistogram::getPercentile(float percentile) const {
+    if (count == 0) return 0.f;
+    
+    std::uint64_t target = static_cast<std::uint64_t>(std::ceil(count * percentile / 100.f));
+    target = std::max<std::uint64_t>(target, 1);
+    
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < BucketCount; ++i) {
+        seen += buckets[i];
+        if (seen >= target) {
+            // Never report more than the slowest sample (the overflow bucket has no upper edge)
+            return i == BucketCount - 1 ? maximum : std::min((i + 1) * BucketWidth, maximum);
+        }
+    }
+    return maximum;
+}
+
+LatencyTracker::LatencyTracker()
+    : log(nullptr)
+    , logInterval(std::chrono::seconds(5))
+    , lastLog(Clock::now())
+{
+    pending.reserve(MaxPending);
+}
+
+void LatencyTracker::recordInput(const sf::Event& event, Clock::time_point arrival) {
+    InputKind kind;
+    if (event.is<sf::Event::MouseButtonPressed>()) {
+        kind = InputKind::MousePress;
+    } else if (event.is<sf::Event::MouseButtonReleased>()) {
+        kind = InputKind::MouseRelease;
+    } else if (event.is<sf::Event::MouseMoved>()) {
+        kind = InputKind::MouseMove;
+    } else if (event.is<sf::Event::KeyPressed>() || event.is<sf::Event::KeyReleased>()) {
+        kind = InputKind::Key;
+    } else {
+        return; // Not user input
+    }
+    
+    // Without presented frames the oldest inputs would never be closed out
+    if (pending.size() == MaxPending) {
+        pending.erase(pending.begin());
+    }
+    pending.push_back({kind, arrival});
+}
+
+void LatencyTracker::onFramePresented() {
+    Clock::time_point presented = Clock::now();
+    
+    for (const auto& input : pending) {
+        float milliseconds = std::chrono::duration<float, std::milli>(presented - input.arrival).count();
+        histograms[static_cast<std::size_t>(input.kind)].add(milliseconds);
+    }
+    pending.clear();
+    
+    if (log && presented - lastLog >= logInterval) {
+        writeSummary(*log);
+        lastLog = presented;
+    }
+}
+
+void LatencyTracker::reset() {
+    for (auto& histogram : histograms) {
+        histogram.clear();
+    }
+    pending.clear();
+}
+
+void LatencyTracker::setLog(std::ostream* stream, float intervalSeconds) {
+    log = stream;
+    logInterval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(intervalSeconds));
+    lastLog = Clock::now();
+}
+
+void LatencyTracker::writeSummary(std::ostream& stream) const {
+    // Leave the caller's number formatting as it was
+    std::ios_base::fmtflags flags = stream.flags();
+    std::streamsize precision = stream.precision();
+    
+    stream << "Input latency (ms)      count     mean      p50      p95      p99      max\n";
+    stream << std::fixed << std::setprecision(2);
+    for (std::size_t i = 0; i < KindCount; ++i) {
+        const LatencyHistogram& histogram = histograms[i];
+        if (histogram.getCount() == 0) continue;
+        
+        stream << "  " << std::left << std::setw(16) << getKindName(static_cast<InputKind>(i)) << std::right
+               << std::setw(11) << histogram.getCount()
+               << std::setw(9) << histogram.getMean()
+               << std::setw(9) << histogram.getPercentile(50.f)
+               << std::setw(9) << histogram.getPercentile(95.f)
+               << std::setw(9) << histogram.getPercentile(99.f)
+               << std::setw(9) << histogram.getMax() << "\n";
+    }
+    
+    stream.flags(flags);
+    stream.precision(precision);
+}
+
+const char* LatencyTracker::getKindName(InputKind kind) {
+    switch (kind) {
+        case InputKind::MousePress: return "mouse press";
+        case InputKind::MouseRelease: return "mouse release";
+        case InputKind::MouseMove: return "mouse move";
+        case InputKind::Key: return "key";
+        default: return "unknown";
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Fixed-bucket histogram of latencies in milliseconds
+class LatencyHistogram {
+public:
+    static constexpr float BucketWidth = 0.25f;    // ms
+    static const std::size_t BucketCount = 400;     // Up to 100 ms; slower samples go in the last bucket
+    
+    void add(float milliseconds);
+    void clear();
+    
+    std::uint64_t getCount() const { return count; }
+    float getMin() const { return count ? minimum : 0.f; }
+    float getMax() const { return maximum; }
+    float getMean() const { return count ? static_cast<float>(sum / count) : 0.f; }
+    
+    // Upper edge of the bucket holding the given percentile (0-100)
+    float getPercentile(float percentile) const;
+    
+    const std::array<std::uint32_t, BucketCount>& getBuckets() const { return buckets; }
+
+private:
+    std::array<std::uint32_t, BucketCount> buckets{};
+    std::uint64_t count = 0;
+    double sum = 0.0;
+    float minimum = 0.f;
+    float maximum = 0.f;
+};
+
+// Measures input-to-photon latency: the time from an input event being taken
+// off the window's queue to the display() call that presents its effect.
+// Events are stamped when polled, tagged when a handler consumes them and
+// closed out when the frame is presented.
+class LatencyTracker {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    enum class InputKind {
+        MousePress,
+        MouseRelease,
+        MouseMove,
+        Key,
+        Count
+    };
+    
+    LatencyTracker();
+    
+    // An input event was consumed; it will be shown by the next presented frame
+    void recordInput(const sf::Event& event, Clock::time_point arrival);
+    
+    // Call right after window.display()
+    void onFramePresented();
+    
+    const LatencyHistogram& getHistogram(InputKind kind) const { return histograms[static_cast<std::size_t>(kind)]; }
+    void reset();
+    
+    // Write a summary to stream every intervalSeconds (nullptr to stop logging)
+    void setLog(std::ostream* stream, float intervalSeconds = 5.f);
+    void writeSummary(std::ostream& stream) const;
+    
+    static const char* getKindName(InputKind kind);
+
+private:
+    struct PendingInput {
+        InputKind kind;
+        Clock::time_point arrival;
+    };
+    
+    static const std::size_t KindCount = static_cast<std::size_t>(InputKind::Count);
+    
+    // Inputs kept while no frame is presented (idle or headless); older ones are dropped
+    static const std::size_t MaxPending = 64;
+    
+    std::array<LatencyHistogram, KindCount> histograms;
+    std::vector<PendingInput> pending;    // Consumed since the last presented frame
+    std::ostream* log;
+    Clock::duration logInterval;
+    Clock::time_point lastLog;
+};
@@ -0,0 +1,226 @@
+#include "MetricsRecorder.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+
+namespace {
+    // Lowercase column key: spaces become underscores
+    std::string columnKey(const char* name, const char* suffix = "") {
+        std::string key = name;
+        std::replace(key.begin(), key.end(), ' ', '_');
+        return key + suffix;
+    }
+    
+    bool endsWith(const std::string& text, const std::string& suffix) {
+        return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+}
+
+MetricsRecorder::MetricsRecorder()
+    : format(Format::Binary)
+    , stopping(false)
+    , recordCount(0)
+    , sectionTotals{}
+    , sectionMaximums{}
+    , counterTotals{}
+    , counterMaximums{}
+{
+    columnNames.push_back("frame");
+    columnNames.push_back("frame_ms");
+    for (std::size_t i = 0; i < FrameProfiler::SectionCount; ++i) {
+        columnNames.push_back(columnKey(FrameProfiler::getSectionName(static_cast<FrameProfiler::Section>(i)), "_ms"));
+    }
+    for (std::size_t i = 0; i < FrameProfiler::CounterCount; ++i) {
+        columnNames.push_back(columnKey(FrameProfiler::getCounterName(static_cast<FrameProfiler::Counter>(i))));
+    }
+}
+
+MetricsRecorder::~MetricsRecorder() {
+    close();
+}
+
+bool MetricsRecorder::open(const std::string& filename) {
+    if (endsWith(filename, ".csv")) return open(filename, Format::Csv);
+    if (endsWith(filename, ".jsonl")) return open(filename, Format::JsonLines);
+    return open(filename, Format::Binary);
+}
+
+bool MetricsRecorder::open(const std::string& filename, Format fileFormat) {
+    close();
+    
+    file.open(filename, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+    
+    path = filename;
+    format = fileFormat;
+    
+    if (format == Format::Binary) {
+        BinaryHeader header = {};
+        header.magic = Magic;
+        header.version = Version;
+        header.sectionCount = static_cast<std::uint32_t>(FrameProfiler::SectionCount);
+        header.counterCount = static_cast<std::uint32_t>(FrameProfiler::CounterCount);
+        header.recordSize = static_cast<std::uint32_t>(sizeof(FrameProfiler::Frame));
+        file.write(reinterpret_cast<const char*>(&header), sizeof(BinaryHeader));
+    } else if (format == Format::Csv) {
+        for (std::size_t i = 0; i < columnNames.size(); ++i) {
+            file << (i ? "," : "") << columnNames[i];
+        }
+        file << "\n";
+    }
+    
+    // Both buffers keep their capacity as they are swapped, so steady recording doesn't allocate
+    pending.reserve(QueueCapacity);
+    writing.reserve(QueueCapacity);
+    stopping = false;
+    writer = std::thread(&MetricsRecorder::writerLoop, this);
+    return true;
+}
+
+void MetricsRecorder::close() {
+    if (!writer.joinable()) return;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    writer.join();
+    file.close();
+}
+
+void MetricsRecorder::record(const FrameProfiler::Frame& frame) {
+    recordCount++;
+    frameTimes.add(frame.frameTime);
+    for (std::size_t i = 0; i < FrameProfiler::SectionCount; ++i) {
+        sectionTotals[i] += frame.sectionTimes[i];
+        sectionMaximums[i] = std::max(sectionMaximums[i], frame.sectionTimes[i]);
+    }
+    for (std::size_t i = 0; i < FrameProfiler::CounterCount; ++i) {
+        counterTotals[i] += frame.counters[i];
+        counterMaximums[i] = std::max(counterMaximums[i], frame.counters[i]);
+    }
+    
+    // Without a file only the summary is kept
+    if (!writer.joinable()) return;
+    
+    bool batchReady;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(frame);
+        batchReady = pending.size() >= BatchSize;
+    }
+    if (batchReady) {
+        wake.notify_one();
+    }
+}
+
+void MetricsRecorder::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    bool finished = false;
+    while (!finished) {
+        wake.wait_for(lock, std::chrono::duration<float>(WriteInterval), [this]() {
+            return stopping || pending.size() >= BatchSize;
+        });
+        
+        // Take the queued records and write them without holding the lock.
+        // Nothing is recorded after close(), so the batch taken while stopping is the last.
+        writing.swap(pending);
+        finished = stopping;
+        lock.unlock();
+        
+        writeRecords(writing);
+        writing.clear();
+        
+        lock.lock();
+    }
+    
+    file.flush();
+}
+
+void MetricsRecorder::writeRecords(const std::vector<FrameProfiler::Frame>& frames) {
+    if (frames.empty()) return;
+    
+    if (format == Format::Binary) {
+        file.write(reinterpret_cast<const char*>(frames.data()),
+                   static_cast<std::streamsize>(frames.size() * sizeof(FrameProfiler::Frame)));
+        return;
+    }
+    
+    // Formatted into a fixed buffer, one line per frame
+    bool json = format == Format::JsonLines;
+    char line[1024];
+    for (const FrameProfiler::Frame& frame : frames) {
+        int length = 0;
+        std::size_t column = 0;
+        auto field = [&]() {
+            if (json) {
+                length += std::snprintf(line + length, sizeof(line) - length, "%s\"%s\":",
+                                        column ? "," : "{", columnNames[column].c_str());
+            } else if (column) {
+                line[length++] = ',';
+            }
+            column++;
+        };
+        
+        field();
+        length += std::snprintf(line + length, sizeof(line) - length, "%llu",
+                                static_cast<unsigned long long>(frame.index));
+        field();
+        length += std::snprintf(line + length, sizeof(line) - length, "%.4f", frame.frameTime);
+        for (float milliseconds : frame.sectionTimes) {
+            field();
+            length += std::snprintf(line + length, sizeof(line) - length, "%.4f", milliseconds);
+        }
+        for (std::uint64_t count : frame.counters) {
+            field();
+            length += std::snprintf(line + length, sizeof(line) - length, "%llu",
+                                    static_cast<unsigned long long>(count));
+        }
+        length += std::snprintf(line + length, sizeof(line) - length, json ? "}\n" : "\n");
+        
+        file.write(line, length);
+    }
+}
+
+void MetricsRecorder::writeSummary(std::ostream& stream) const {
+    if (recordCount == 0) return;
+    
+    // Leave the caller's number formatting as it was
+    std::ios_base::fmtflags flags = stream.flags();
+    std::streamsize precision = stream.precision();
+    
+    stream << "Frame metrics: " << recordCount << " frames";
+    if (!path.empty()) {
+        stream << ", written to " << path;
+    }
+    stream << "\n" << std::fixed << std::setprecision(2);
+    
+    stream << "  frame time (ms)        mean      p50      p95      p99      max\n";
+    stream << "  " << std::setw(27) << frameTimes.getMean()
+           << std::setw(9) << frameTimes.getPercentile(50.f)
+           << std::setw(9) << frameTimes.getPercentile(95.f)
+           << std::setw(9) << frameTimes.getPercentile(99.f)
+           << std::setw(9) << frameTimes.getMax() << "\n";
+    
+    stream << "  system (ms)            mean      max\n";
+    for (std::size_t i = 0; i < FrameProfiler::SectionCount; ++i) {
+        stream << "    " << std::left << std::setw(16)
+               << FrameProfiler::getSectionName(static_cast<FrameProfiler::Section>(i)) << std::right
+               << std::setw(9) << sectionTotals[i] / recordCount
+               << std::setw(9) << sectionMaximums[i] << "\n";
+    }
+    
+    stream << "  count                  mean      max      total\n";
+    for (std::size_t i = 0; i < FrameProfiler::CounterCount; ++i) {
+        stream << "    " << std::left << std::setw(16)
+               << FrameProfiler::getCounterName(static_cast<FrameProfiler::Counter>(i)) << std::right
+               << std::setw(9) << static_cast<double>(counterTotals[i]) / recordCount
+               << std::setw(9) << counterMaximums[i]
+               << std::setw(11) << counterTotals[i] << "\n";
+    }
+    
+    stream.flags(flags);
+    stream.precision(precision);
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "FrameProfiler.hpp"
+#include "LatencyTracker.hpp"
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Writes every profiled frame to a file for offline analysis: frame index,
+// frame time, the time of each system and the profiler's counters. record()
+// only queues a copy of the frame; a background thread formats and writes
+// the records, so the game loop never waits on the disk.
+class MetricsRecorder {
+public:
+    enum class Format {
+        Csv,            // Header line, then one row per frame
+        JsonLines,      // One object per line
+        Binary          // Header, then raw FrameProfiler::Frame records
+    };
+    
+    // Binary file header
+    struct BinaryHeader {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t sectionCount;
+        std::uint32_t counterCount;
+        std::uint32_t recordSize;
+    };
+    
+    static const std::uint32_t Magic = 0x464D474D;     // "MGMF"
+    static const std::uint32_t Version = 1;
+    
+    MetricsRecorder();
+    ~MetricsRecorder();
+    
+    MetricsRecorder(const MetricsRecorder&) = delete;
+    MetricsRecorder& operator=(const MetricsRecorder&) = delete;
+    
+    // Start writing to filename, picking the format from its extension (.csv, .jsonl, anything else binary)
+    bool open(const std::string& filename);
+    bool open(const std::string& filename, Format format);
+    
+    // Write everything still queued and close the file
+    void close();
+    
+    bool isOpen() const { return writer.joinable(); }
+    
+    // Queue one finished frame
+    void record(const FrameProfiler::Frame& frame);
+    
+    std::uint64_t getRecordCount() const { return recordCount; }
+    
+    // Frame time percentiles, mean and worst time of each system and counter totals
+    void writeSummary(std::ostream& stream) const;
+
+private:
+    // Records handed to the writer at a time; it also wakes up on its own every WriteInterval
+    static const std::size_t BatchSize = 256;
+    
+    // Records both buffers hold before they grow, enough for the writer to fall well behind
+    static const std::size_t QueueCapacity = BatchSize * 16;
+    static constexpr float WriteInterval = 0.1f;    // Seconds
+    
+    void writerLoop();
+    void writeRecords(const std::vector<FrameProfiler::Frame>& frames);
+    
+    std::ofstream file;
+    std::string path;
+    Format format;
+    std::vector<std::string> columnNames;  // Frame, frame time, one per section, one per counter
+    std::thread writer;
+    
+    // Shared with the writer thread
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<FrameProfiler::Frame> pending;
+    bool stopping;
+    
+    // Batch being written, owned by the writer thread
+    std::vector<FrameProfiler::Frame> writing;
+    
+    // Aggregates, updated by record()
+    std::uint64_t recordCount;
+    LatencyHistogram frameTimes;
+    std::array<double, FrameProfiler::SectionCount> sectionTotals;
+    std::array<float, FrameProfiler::SectionCount> sectionMaximums;
+    std::array<std::uint64_t, FrameProfiler::CounterCount> counterTotals;
+    std::array<std::uint64_t, FrameProfiler::CounterCount> counterMaximums;
+};
@@ -0,0 +1,124 @@
+#include "WorldSnapshot.hpp"
+#include <algorithm>
+
+namespace {
+    bool sameWall(const WallSpec& a, const WallSpec& b) {
+        return a.position == b.position && a.size == b.size && a.rotation == b.rotation && a.color == b.color;
+    }
+}
+
+std::shared_ptr<const WorldSnapshot::WallBlock> WorldSnapshot::findWalls(int chunk, int layout,
+                                                                         std::size_t wallCount) const {
+    for (const WallRun& run : wallRuns) {
+        if (run.chunk == chunk && run.layout == layout && run.walls->size() == wallCount) return run.walls;
+    }
+    return nullptr;
+}
+
+bool WorldSnapshot::matches(const WorldSnapshot& other) const {
+    // Ball
+    if (hasBall != other.hasBall) return false;
+    if (hasBall && (ball.position != other.ball.position || ball.velocity != other.ball.velocity)) return false;
+    
+    // Walls, run by run
+    if (wallRuns.size() != other.wallRuns.size()) return false;
+    for (std::size_t i = 0; i < wallRuns.size(); ++i) {
+        const WallBlock& walls = *wallRuns[i].walls;
+        const WallBlock& otherWalls = *other.wallRuns[i].walls;
+        if (wallRuns[i].chunk != other.wallRuns[i].chunk || wallRuns[i].layout != other.wallRuns[i].layout ||
+            walls.size() != otherWalls.size()) {
+            return false;
+        }
+        if (!std::equal(walls.begin(), walls.end(), otherWalls.begin(), sameWall)) return false;
+    }
+    
+    // Generation progress
+    const ObstacleGenerator::State& a = generator;
+    const ObstacleGenerator::State& b = other.generator;
+    if (a.lastGenerationPos != b.lastGenerationPos || a.requiredChunk != b.requiredChunk ||
+        a.activeChunk != b.activeChunk || a.nextWall != b.nextWall ||
+        a.liveChunks != b.liveChunks || a.pendingChunks != b.pendingChunks) {
+        return false;
+    }
+    
+    // The ghost run's clock and recording
+    if (ghosts.runTime != other.ghosts.runTime || ghosts.recordedTime != other.ghosts.recordedTime ||
+        ghosts.recordedPosition != other.ghosts.recordedPosition ||
+        ghosts.recordedTicks != other.ghosts.recordedTicks) {
+        return false;
+    }
+    
+    // Particles, byte for byte, the trail timer and the emitter's next random numbers
+    if (particleTimer != other.particleTimer ||
+        particles.particleCount != other.particles.particleCount ||
+        particles.emissionBudget != other.particles.emissionBudget ||
+        particles.particles != other.particles.particles) {
+        return false;
+    }
+    FastRng rng = particles.rng;
+    FastRng otherRng = other.particles.rng;
+    return rng.next() == otherRng.next() && rng.next() == otherRng.next();
+}
+
+std::size_t WorldSnapshot::getBufferBytes() const {
+    return sizeof(WorldSnapshot) + wallRuns.capacity() * sizeof(WallRun) +
+           (generator.liveChunks.capacity() + generator.pendingChunks.capacity()) * sizeof(int) +
+           particles.particles.capacity();
+}
+
+SnapshotHistory::SnapshotHistory(std::size_t capacity)
+    : slots(std::max<std::size_t>(capacity, 2))     // The latest snapshot must survive a push to share its walls
+    , first(0)
+    , count(0)
+{
+}
+
+WorldSnapshot& SnapshotHistory::push() {
+    std::size_t slot = (first + count) % slots.size();
+    if (count == slots.size()) {
+        first = (first + 1) % slots.size();
+    } else {
+        count++;
+    }
+    return slots[slot];
+}
+
+const WorldSnapshot* SnapshotHistory::latest() const {
+    return count > 0 ? &slots[(first + count - 1) % slots.size()] : nullptr;
+}
+
+void SnapshotHistory::pop() {
+    if (count == 0) return;
+    
+    // Release its wall blocks but keep the buffers for the next snapshot in the slot
+    slots[(first + count - 1) % slots.size()].wallRuns.clear();
+    count--;
+}
+
+void SnapshotHistory::clear() {
+    while (count > 0) {
+        pop();
+    }
+}
+
+std::size_t SnapshotHistory::getByteSize() const {
+    std::size_t bytes = 0;
+    for (std::size_t i = 0; i < slots.size(); ++i) {
+        bytes += slots[i].getBufferBytes();
+        
+        // Blocks shared with an earlier slot are counted there
+        for (const WorldSnapshot::WallRun& run : slots[i].wallRuns) {
+            bool counted = false;
+            for (std::size_t j = 0; j < i && !counted; ++j) {
+                for (const WorldSnapshot::WallRun& earlier : slots[j].wallRuns) {
+                    if (earlier.walls == run.walls) {
+                        counted = true;
+                        break;
+                    }
+                }
+            }
+            if (!counted) bytes += run.walls->capacity() * sizeof(WallSpec);
+        }
+    }
+    return bytes;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include "../entities/Ball.hpp"
+#include "../systems/GhostSystem.hpp"
+#include "../systems/ObstacleGenerator.hpp"
+#include "../systems/ParticleSystem.hpp"
+#include "../utils/MemoryTracker.hpp"
+
+// The simulation state of the whole world at one moment: the ball, every
+// wall, the generator's progress, the particle pool and the ghost run's
+// clock, all held in flat buffers. Walls are stored per chunk in blocks that
+// never change once written, so a chunk built from the same layout with as
+// many walls as in the previous snapshot shares that snapshot's block instead
+// of being copied again.
+struct WorldSnapshot {
+    using WallBlock = Memory::TaggedVector<WallSpec, Memory::Tag::Snapshots>;
+    
+    // Consecutive obstacles of one chunk, in entity order
+    struct WallRun {
+        int chunk;
+        int layout;         // ObstacleGenerator::getBuiltLayout of the chunk
+        std::shared_ptr<const WallBlock> walls;
+    };
+    
+    bool hasBall = false;
+    Ball::State ball;
+    Memory::TaggedVector<WallRun, Memory::Tag::Snapshots> wallRuns;
+    ObstacleGenerator::State generator;
+    ParticleSystem::State particles;
+    float particleTimer = 0.f;          // Time since the last trail particles
+    GhostSystem::State ghosts;
+    float captureMicroseconds = 0.f;
+    
+    // Walls of chunk in this snapshot, if they were built from layout and there are exactly wallCount of them
+    std::shared_ptr<const WallBlock> findWalls(int chunk, int layout, std::size_t wallCount) const;
+    
+    // True when other holds the same world (generation statistics and timings aside)
+    bool matches(const WorldSnapshot& other) const;
+    
+    // Memory of the snapshot's own buffers (wall blocks not included)
+    std::size_t getBufferBytes() const;
+};
+
+// The snapshots of the last few shots. Slots are reused, so once their buffers
+// have grown, capturing only allocates blocks for walls that changed.
+class SnapshotHistory {
+public:
+    explicit SnapshotHistory(std::size_t capacity = 32);
+    
+    // Slot for a new snapshot; when every slot is used the oldest snapshot is dropped
+    WorldSnapshot& push();
+    
+    // Most recent snapshot (nullptr if there is none)
+    const WorldSnapshot* latest() const;
+    
+    // Drop the most recent snapshot
+    void pop();
+    void clear();
+    
+    std::size_t size() const { return count; }
+    std::size_t capacity() const { return slots.size(); }
+    bool empty() const { return count == 0; }
+    
+    // Memory held by every slot, counting shared wall blocks once
+    std::size_t getByteSize() const;
+
+private:
+    Memory::TaggedVector<WorldSnapshot, Memory::Tag::Snapshots> slots;
+    std::size_t first;      // Oldest snapshot
+    std::size_t count;
+};
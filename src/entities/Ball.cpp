@@ -47,24 +47,26 @@ void Ball::update(float deltaTime) {
     line[0].position = position;
 }
 
-void Ball::draw(sf::RenderWindow& window) {
+void Ball::draw(CountingRenderTarget& target) {
     // Draw the actual ball
-    window.draw(shape);
-    
-    // Draw the drag line when dragging
+    target.draw(shape);
+}
+
+void Ball::drawOverlay(CountingRenderTarget& target) {
+    // Draw the drag line when dragging (kept sharp when the scene is downscaled)
     if (isDragging) {
-        window.draw(line, 2, sf::PrimitiveType::Lines);
-        window.draw(arrowHead, 3, sf::PrimitiveType::Triangles);
+        target.draw(line, 2, sf::PrimitiveType::Lines);
+        target.draw(arrowHead, 3, sf::PrimitiveType::Triangles);
     }
 }
 
-void Ball::drawShadow(sf::RenderWindow& window) {
+void Ball::drawShadow(CountingRenderTarget& target) {
     // Draw shadow (slightly larger, offset, and semi-transparent black)
     sf::CircleShape shadow = shape;
     shadow.setPosition({position.x + 6.f, position.y + 6.f});  // Offset shadow
     shadow.setFillColor(sf::Color(0, 0, 0, 70));  // Semi-transparent black
     shadow.setRadius(shape.getRadius() * 1.1f);   // Slightly smaller shadow
-    window.draw(shadow);
+    target.draw(shadow);
 }
 
 bool Ball::handleMousePress(const sf::Vector2f& mousePos) {
@@ -157,14 +159,26 @@ void Ball::updateArrowHead() {
     arrowHead[2].position = baseRight;
 }
 
+void Ball::setPosition(const sf::Vector2f& newPosition) {
+    position = newPosition;
+    shape.setPosition(position);
+    line[0].position = position;
+}
+
+void Ball::setState(const State& state) {
+    isDragging = false;
+    velocity = state.velocity;
+    setPosition(state.position);
+}
+
 sf::FloatRect Ball::getBounds() const {
     return shape.getGlobalBounds();
 }
 
-void Ball::checkCollision(const Obstacle& obstacle) {
+bool Ball::checkCollision(const Obstacle& obstacle) {
     // Skip collision check if not moving
     if (velocity.x == 0 && velocity.y == 0) {
-        return;
+        return false;
     }
     
     // Calculate the center point of the ball
@@ -204,5 +218,9 @@ void Ball::checkCollision(const Obstacle& obstacle) {
             // Call the callback with collision point and normal
             onCollision(collisionPoint, collisionNormal);
         }
+        
+        return true;
     }
+    
+    return false;
 } 
\ No newline at end of file
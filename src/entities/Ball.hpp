@@ -16,19 +16,37 @@ public:
     Ball(float radius = 20.f);
     
     void update(float deltaTime) override;
-    void draw(sf::RenderWindow& window) override;
-    void drawShadow(sf::RenderWindow& window) override;
+    void draw(CountingRenderTarget& target) override;
+    void drawShadow(CountingRenderTarget& target) override;
+    void drawOverlay(CountingRenderTarget& target) override;
     bool handleMousePress(const sf::Vector2f& mousePos) override;
     bool handleMouseRelease(const sf::Vector2f& mousePos) override;
     bool handleMouseMove(const sf::Vector2f& mousePos) override;
     
     // Collision methods
-    void checkCollision(const Obstacle& obstacle);
+    // Returns true if the ball hit the obstacle and bounced off it
+    bool checkCollision(const Obstacle& obstacle);
     sf::FloatRect getBounds() const;
     sf::Vector2f getPosition() const { return position; }
     sf::Vector2f getVelocity() const { return velocity; }
     float getRadius() const { return shape.getRadius(); }
     
+    // Move the ball without a shot, and shoot it without a drag (simulations and tools)
+    void setPosition(const sf::Vector2f& newPosition);
+    void setVelocity(const sf::Vector2f& newVelocity) { velocity = newVelocity; }
+    
+    // Where the ball is and how it moves, for snapshots
+    struct State {
+        sf::Vector2f position;
+        sf::Vector2f velocity;
+    };
+    State getState() const { return {position, velocity}; }
+    
+    // Put the ball back in a saved state, ending any drag
+    void setState(const State& state);
+    
+    bool isDragged() const { return isDragging; }
+    
     // Set callbacks
     void setCollisionCallback(CollisionCallback callback) { onCollision = callback; }
     void setMovementCallback(MovementCallback callback) { onMovement = callback; }
@@ -2,7 +2,9 @@
 #include <cmath>
 #include <array>
 
-Obstacle::Obstacle(const sf::Vector2f& position, const sf::Vector2f& size, const sf::Color& color) {
+Obstacle::Obstacle(const sf::Vector2f& position, const sf::Vector2f& size, const sf::Color& color)
+    : chunk(-1)
+{
     shape.setSize(size);
     shape.setPosition(position);
     shape.setFillColor(color);
@@ -13,18 +15,18 @@ void Obstacle::update(float deltaTime) {
     // Obstacles are static, so no update logic needed
 }
 
-void Obstacle::draw(sf::RenderWindow& window) {
+void Obstacle::draw(CountingRenderTarget& target) {
     // Draw the actual obstacle
-    window.draw(shape);
+    target.draw(shape);
 }
 
-void Obstacle::drawShadow(sf::RenderWindow& window) {
+void Obstacle::drawShadow(CountingRenderTarget& target) {
     // Draw shadow (slightly offset and semi-transparent black)
     sf::RectangleShape shadow = shape;
     shadow.setPosition({shape.getPosition().x + 5.f, shape.getPosition().y + 5.f});
     shadow.setFillColor(sf::Color(0, 0, 0, 70));  // Semi-transparent black
     shadow.setRotation(shape.getRotation());  // Match the rotation of the original shape
-    window.draw(shadow);
+    target.draw(shadow);
 }
 
 sf::FloatRect Obstacle::getBounds() const {
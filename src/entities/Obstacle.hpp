@@ -10,8 +10,8 @@ public:
              const sf::Color& color = Colors::Gray);
     
     void update(float deltaTime) override;
-    void draw(sf::RenderWindow& window) override;
-    void drawShadow(sf::RenderWindow& window) override;
+    void draw(CountingRenderTarget& target) override;
+    void drawShadow(CountingRenderTarget& target) override;
     
     // Standard bounds calculation (for non-collision uses)
     sf::FloatRect getBounds() const;
@@ -28,6 +28,12 @@ public:
     // Get the size of the obstacle
     sf::Vector2f getSize() const;
     
+    sf::Color getColor() const { return shape.getFillColor(); }
+    
+    // Course chunk this obstacle was generated for (-1 if not part of one)
+    void setChunk(int chunkIndex) { chunk = chunkIndex; }
+    int getChunk() const { return chunk; }
+    
     // Check precise collision with a circle (for ball collision)
     bool checkCircleCollision(const sf::Vector2f& circleCenter, float radius, 
                              sf::Vector2f& collisionPoint, sf::Vector2f& collisionNormal) const;
@@ -43,4 +49,5 @@ private:
                                   sf::Vector2f& closestPoint) const;
     
     sf::RectangleShape shape;
+    int chunk;
 }; 
\ No newline at end of file
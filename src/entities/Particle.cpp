@@ -44,12 +44,12 @@ void Particle::update(float deltaTime) {
     shape.setOrigin({size * scale, size * scale});
 }
 
-void Particle::draw(sf::RenderWindow& window) {
+void Particle::draw(CountingRenderTarget& target) {
     if (isAlive()) {
-        window.draw(shape);
+        target.draw(shape);
     }
 }
 
-void Particle::drawShadow(sf::RenderWindow& window) {
+void Particle::drawShadow(CountingRenderTarget& target) {
     // Particles are small and short-lived, no need for shadows
 } 
\ No newline at end of file
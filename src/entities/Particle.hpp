@@ -8,8 +8,8 @@ public:
     Particle(const sf::Vector2f& position, const sf::Vector2f& velocity, float lifetime = 0.5f, float size = 3.f);
     
     void update(float deltaTime) override;
-    void draw(sf::RenderWindow& window) override;
-    void drawShadow(sf::RenderWindow& window) override;
+    void draw(CountingRenderTarget& target) override;
+    void drawShadow(CountingRenderTarget& target) override;
     
     bool isAlive() const { return remainingLifetime > 0.f; }
     
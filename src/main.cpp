@@ -1,14 +1,37 @@
 #include <SFML/Graphics.hpp>
+#include <cstring>
+#include <iostream>
 #include <memory>
 #include "core/Game.hpp"
+#include "core/MetricsRecorder.hpp"
 #include "utils/Colors.hpp"
+#include "utils/MemoryTracker.hpp"
 #include "entities/Ball.hpp"
 #include "entities/Obstacle.hpp"
 
-int main()
+int main(int argc, char* argv[])
 {
     Game game;
     
+    // --metrics <file> records every frame (.csv, .jsonl or binary)
+    // --course <file> plays a course file, --ghost <file> races a recorded run on it
+    // --save-ghost <file> saves this run as a ghost on exit
+    const char* ghostOutput = nullptr;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--metrics") == 0 && !game.recordMetrics(argv[i + 1])) {
+            std::cerr << "Could not open metrics file " << argv[i + 1] << "\n";
+        }
+        if (std::strcmp(argv[i], "--course") == 0 && !game.loadCourse(argv[i + 1])) {
+            std::cerr << "Could not load course " << argv[i + 1] << "\n";
+        }
+        if (std::strcmp(argv[i], "--ghost") == 0 && !game.loadGhost(argv[i + 1])) {
+            std::cerr << "Could not load ghost " << argv[i + 1] << "\n";
+        }
+        if (std::strcmp(argv[i], "--save-ghost") == 0) {
+            ghostOutput = argv[i + 1];
+        }
+    }
+    
     // Add a ball to the game
     auto ball = std::make_unique<Ball>();
     game.addEntity(std::move(ball));
@@ -16,5 +39,16 @@ int main()
     // Run the game - obstacles will be generated dynamically
     game.run();
     
+    if (ghostOutput && !game.saveGhost(ghostOutput)) {
+        std::cerr << "Could not save ghost " << ghostOutput << "\n";
+    }
+    
+    // Where memory went during the session (peaks show growth over long runs)
+    Memory::writeReport(std::cout);
+    
+    if (game.getMetrics()) {
+        game.getMetrics()->writeSummary(std::cout);
+    }
+    
     return 0;
 }
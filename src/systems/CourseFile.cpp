@@ -0,0 +1,180 @@
+#include "CourseFile.hpp"
+#include <algorithm>
+#include <fstream>
+
+namespace {
+    std::uint64_t alignOffset(std::uint64_t offset) {
+        return (offset + 7) & ~std::uint64_t(7);
+    }
+    
+    // Check that an array of count elements starting at offset lies inside the file
+    bool sectionFits(std::uint64_t offset, std::uint64_t count, std::uint64_t elementSize, std::uint64_t fileSize) {
+        if (offset % 4 != 0 || offset > fileSize) return false;
+        return count <= (fileSize - offset) / elementSize;
+    }
+    
+    template <typename T>
+    void writeSection(std::ofstream& out, std::uint64_t offset, const std::vector<T>& data) {
+        // Pad up to the section start
+        static const char zeros[8] = {};
+        std::uint64_t position = static_cast<std::uint64_t>(out.tellp());
+        out.write(zeros, static_cast<std::streamsize>(offset - position));
+        out.write(reinterpret_cast<const char*>(data.data()),
+                  static_cast<std::streamsize>(data.size() * sizeof(T)));
+    }
+}
+
+bool CourseFile::save(const std::string& filename, std::uint64_t seed, std::vector<CourseChunk> courseChunks) {
+    using namespace CourseFormat;
+    
+    std::sort(courseChunks.begin(), courseChunks.end(),
+        [](const CourseChunk& a, const CourseChunk& b) { return a.index < b.index; });
+    
+    // Flatten the chunks into packed arrays
+    std::vector<ChunkEntry> entries;
+    std::vector<Vec2> positions;
+    std::vector<Vec2> sizes;
+    std::vector<float> rotations;
+    std::vector<std::uint32_t> colors;
+    std::vector<Segment> pathSegments;
+    
+    for (const auto& chunk : courseChunks) {
+        ChunkEntry entry;
+        entry.index = chunk.index;
+        entry.firstWall = static_cast<std::uint32_t>(positions.size());
+        entry.wallCount = static_cast<std::uint32_t>(chunk.walls.size());
+        entry.firstSegment = static_cast<std::uint32_t>(pathSegments.size());
+        entry.segmentCount = static_cast<std::uint32_t>(chunk.segments.size());
+        entries.push_back(entry);
+        
+        for (const auto& wall : chunk.walls) {
+            positions.push_back({wall.position.x, wall.position.y});
+            sizes.push_back({wall.size.x, wall.size.y});
+            rotations.push_back(wall.rotation);
+            colors.push_back(wall.color.toInteger());
+        }
+        
+        for (const auto& segment : chunk.segments) {
+            pathSegments.push_back({{segment.start.x, segment.start.y},
+                                    {segment.end.x, segment.end.y},
+                                    segment.width});
+        }
+    }
+    
+    // Lay out the sections
+    Header header = {};
+    header.magic = Magic;
+    header.version = Version;
+    header.seed = seed;
+    header.chunkCount = static_cast<std::uint32_t>(entries.size());
+    header.wallCount = static_cast<std::uint32_t>(positions.size());
+    header.segmentCount = static_cast<std::uint32_t>(pathSegments.size());
+    header.chunkOffset = alignOffset(sizeof(Header));
+    header.wallPositionOffset = alignOffset(header.chunkOffset + entries.size() * sizeof(ChunkEntry));
+    header.wallSizeOffset = alignOffset(header.wallPositionOffset + positions.size() * sizeof(Vec2));
+    header.wallRotationOffset = alignOffset(header.wallSizeOffset + sizes.size() * sizeof(Vec2));
+    header.wallColorOffset = alignOffset(header.wallRotationOffset + rotations.size() * sizeof(float));
+    header.segmentOffset = alignOffset(header.wallColorOffset + colors.size() * sizeof(std::uint32_t));
+    
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+    
+    out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    writeSection(out, header.chunkOffset, entries);
+    writeSection(out, header.wallPositionOffset, positions);
+    writeSection(out, header.wallSizeOffset, sizes);
+    writeSection(out, header.wallRotationOffset, rotations);
+    writeSection(out, header.wallColorOffset, colors);
+    writeSection(out, header.segmentOffset, pathSegments);
+    
+    return static_cast<bool>(out);
+}
+
+bool CourseFile::open(const std::string& filename) {
+    using namespace CourseFormat;
+    
+    header = nullptr;
+    if (!file.open(filename)) return false;
+    
+    const std::uint8_t* base = file.data();
+    std::uint64_t fileSize = file.size();
+    
+    // Validate the header
+    if (fileSize < sizeof(Header)) {
+        file.close();
+        return false;
+    }
+    const Header* candidate = reinterpret_cast<const Header*>(base);
+    if (candidate->magic != Magic || candidate->version != Version) {
+        file.close();
+        return false;
+    }
+    
+    // Validate section bounds so chunk lookups never read outside the mapping
+    bool valid =
+        sectionFits(candidate->chunkOffset, candidate->chunkCount, sizeof(ChunkEntry), fileSize) &&
+        sectionFits(candidate->wallPositionOffset, candidate->wallCount, sizeof(Vec2), fileSize) &&
+        sectionFits(candidate->wallSizeOffset, candidate->wallCount, sizeof(Vec2), fileSize) &&
+        sectionFits(candidate->wallRotationOffset, candidate->wallCount, sizeof(float), fileSize) &&
+        sectionFits(candidate->wallColorOffset, candidate->wallCount, sizeof(std::uint32_t), fileSize) &&
+        sectionFits(candidate->segmentOffset, candidate->segmentCount, sizeof(Segment), fileSize);
+    
+    const ChunkEntry* entries = reinterpret_cast<const ChunkEntry*>(base + candidate->chunkOffset);
+    for (std::uint32_t i = 0; valid && i < candidate->chunkCount; ++i) {
+        const ChunkEntry& entry = entries[i];
+        valid = entry.firstWall <= candidate->wallCount &&
+                entry.wallCount <= candidate->wallCount - entry.firstWall &&
+                entry.firstSegment <= candidate->segmentCount &&
+                entry.segmentCount <= candidate->segmentCount - entry.firstSegment &&
+                (i == 0 || entries[i - 1].index < entry.index);
+    }
+    if (!valid) {
+        file.close();
+        return false;
+    }
+    
+    // Point straight into the mapping
+    header = candidate;
+    chunks = entries;
+    wallPositions = reinterpret_cast<const Vec2*>(base + header->wallPositionOffset);
+    wallSizes = reinterpret_cast<const Vec2*>(base + header->wallSizeOffset);
+    wallRotations = reinterpret_cast<const float*>(base + header->wallRotationOffset);
+    wallColors = reinterpret_cast<const std::uint32_t*>(base + header->wallColorOffset);
+    segments = reinterpret_cast<const Segment*>(base + header->segmentOffset);
+    return true;
+}
+
+const CourseFormat::ChunkEntry* CourseFile::findChunk(int chunkIndex) const {
+    if (!header) return nullptr;
+    
+    // The directory is sorted by chunk index
+    const CourseFormat::ChunkEntry* end = chunks + header->chunkCount;
+    const CourseFormat::ChunkEntry* it = std::lower_bound(chunks, end, chunkIndex,
+        [](const CourseFormat::ChunkEntry& entry, int index) { return entry.index < index; });
+    return (it != end && it->index == chunkIndex) ? it : nullptr;
+}
+
+CourseChunk CourseFile::readChunk(const CourseFormat::ChunkEntry& entry) const {
+    CourseChunk chunk;
+    chunk.index = entry.index;
+    
+    chunk.walls.reserve(entry.wallCount);
+    for (std::uint32_t i = entry.firstWall; i < entry.firstWall + entry.wallCount; ++i) {
+        WallSpec wall;
+        wall.position = sf::Vector2f(wallPositions[i].x, wallPositions[i].y);
+        wall.size = sf::Vector2f(wallSizes[i].x, wallSizes[i].y);
+        wall.rotation = wallRotations[i];
+        wall.color = sf::Color(wallColors[i]);
+        chunk.walls.push_back(wall);
+    }
+    
+    chunk.segments.reserve(entry.segmentCount);
+    for (std::uint32_t i = entry.firstSegment; i < entry.firstSegment + entry.segmentCount; ++i) {
+        const CourseFormat::Segment& segment = segments[i];
+        chunk.segments.push_back({{segment.start.x, segment.start.y},
+                                  {segment.end.x, segment.end.y},
+                                  segment.width});
+    }
+    
+    return chunk;
+}
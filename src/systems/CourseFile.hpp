@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ObstacleGenerator.hpp"
+#include "../utils/MappedFile.hpp"
+
+// Binary course format (little-endian, all sections 8-byte aligned):
+//
+//   Header
+//   ChunkEntry[chunkCount]           sorted by chunk index
+//   Vec2[wallCount]                  wall positions
+//   Vec2[wallCount]                  wall sizes
+//   float[wallCount]                 wall rotations (degrees)
+//   uint32[wallCount]                wall colours (RGBA, sf::Color::toInteger)
+//   Segment[segmentCount]            path segments
+//
+// Each chunk owns a contiguous range of walls and segments, so a chunk can be
+// turned into obstacles straight from the mapped arrays.
+namespace CourseFormat {
+    const std::uint32_t Magic = 0x4643474D;   // "MGCF"
+    const std::uint32_t Version = 1;
+    
+    struct Vec2 {
+        float x;
+        float y;
+    };
+    
+    struct Segment {
+        Vec2 start;
+        Vec2 end;
+        float width;
+    };
+    
+    struct ChunkEntry {
+        std::int32_t index;
+        std::uint32_t firstWall;
+        std::uint32_t wallCount;
+        std::uint32_t firstSegment;
+        std::uint32_t segmentCount;
+    };
+    
+    struct Header {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint64_t seed;
+        std::uint32_t chunkCount;
+        std::uint32_t wallCount;
+        std::uint32_t segmentCount;
+        std::uint32_t reserved;
+        std::uint64_t chunkOffset;
+        std::uint64_t wallPositionOffset;
+        std::uint64_t wallSizeOffset;
+        std::uint64_t wallRotationOffset;
+        std::uint64_t wallColorOffset;
+        std::uint64_t segmentOffset;
+    };
+    
+    static_assert(sizeof(Vec2) == 8, "Vec2 must be packed");
+    static_assert(sizeof(Segment) == 20, "Segment must be packed");
+    static_assert(sizeof(ChunkEntry) == 20, "ChunkEntry must be packed");
+    static_assert(sizeof(Header) == 80, "Header must be packed");
+}
+
+// A course file mapped into memory. Loading only validates the header and
+// the section bounds; chunk data is read in place from the mapping.
+class CourseFile {
+public:
+    CourseFile() = default;
+    
+    // Write chunks (in any order) to a course file
+    static bool save(const std::string& filename, std::uint64_t seed, std::vector<CourseChunk> chunks);
+    
+    // Map and validate a course file
+    bool open(const std::string& filename);
+    
+    bool isOpen() const { return file.isOpen(); }
+    std::uint64_t getSeed() const { return header ? header->seed : 0; }
+    std::uint32_t getChunkCount() const { return header ? header->chunkCount : 0; }
+    std::uint32_t getWallCount() const { return header ? header->wallCount : 0; }
+    
+    // Chunk directory lookup, nullptr if the file doesn't contain the chunk
+    const CourseFormat::ChunkEntry* findChunk(int chunkIndex) const;
+    const CourseFormat::ChunkEntry& chunkAt(std::uint32_t i) const { return chunks[i]; }
+    
+    // Packed arrays, indexed by the ranges in ChunkEntry
+    const CourseFormat::Vec2* getWallPositions() const { return wallPositions; }
+    const CourseFormat::Vec2* getWallSizes() const { return wallSizes; }
+    const float* getWallRotations() const { return wallRotations; }
+    const std::uint32_t* getWallColors() const { return wallColors; }
+    const CourseFormat::Segment* getSegments() const { return segments; }
+    
+    // Copy a chunk out of the file
+    CourseChunk readChunk(const CourseFormat::ChunkEntry& entry) const;
+
+private:
+    MappedFile file;
+    const CourseFormat::Header* header = nullptr;
+    const CourseFormat::ChunkEntry* chunks = nullptr;
+    const CourseFormat::Vec2* wallPositions = nullptr;
+    const CourseFormat::Vec2* wallSizes = nullptr;
+    const float* wallRotations = nullptr;
+    const std::uint32_t* wallColors = nullptr;
+    const CourseFormat::Segment* segments = nullptr;
+};
@@ -0,0 +1,193 @@
+#include "CourseValidator.hpp"
+#include "ObstacleGenerator.hpp"
+#include "../core/JobSystem.hpp"
+#include "../entities/Ball.hpp"
+#include "../entities/Obstacle.hpp"
+#include "../utils/Random.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace {
+    const std::uint64_t ShotSalt = 0x73686F7473ull;
+    
+    // Simulation steps match the game's default frame rate; the ball keeps 99% of its speed per step
+    const float TimeStep = 1.f / 144.f;
+    const float Friction = 0.99f;
+    const int MaxStepsPerShot = 1200;
+    
+    // The simulated player
+    const float MaxShotSpeed = 1000.f;      // A 400 px drag
+    const float AimError = 10.f;            // Degrees either way
+    const float MinPowerError = 0.8f;       // Fraction of the distance to the aim point
+    const float MaxPowerError = 1.3f;
+    const float AimLead = 40.f;             // Path nodes closer than this ahead of the ball are passed
+    const float FinishOvershoot = 150.f;    // Last shot aims this far past the end of the chunk
+    
+    const float StartInset = 40.f;          // Runs start this far into the chunk
+    const float EscapeMargin = 30.f;        // Beyond the path edge (or behind the start) the ball is off course
+    const float Clearance = 1.1f;           // Gap needed between the walls, relative to the ball's diameter
+    const float CentrelineStep = 20.f;      // Spacing of the clearance checks along the path
+    
+    float length(const sf::Vector2f& vector) {
+        return std::sqrt(vector.x * vector.x + vector.y * vector.y);
+    }
+    
+    float distanceToSegment(const sf::Vector2f& point, const PathSegment& segment) {
+        sf::Vector2f direction = segment.end - segment.start;
+        float lengthSquared = direction.x * direction.x + direction.y * direction.y;
+        float t = ((point.x - segment.start.x) * direction.x + (point.y - segment.start.y) * direction.y) / lengthSquared;
+        t = std::clamp(t, 0.f, 1.f);
+        return length(point - (segment.start + direction * t));
+    }
+    
+    struct RunResult {
+        bool success = false;
+        int shots = 0;
+    };
+    
+    // Walls of the chunk, with the radius of a circle around each for a cheap first test
+    struct Walls {
+        std::vector<Obstacle> obstacles;
+        std::vector<float> reach;
+    };
+    
+    bool isPinched(const CourseChunk& chunk, const Walls& walls, float ballRadius) {
+        sf::Vector2f collisionPoint;
+        sf::Vector2f collisionNormal;
+        float radius = ballRadius * Clearance;
+        
+        for (const PathSegment& segment : chunk.segments) {
+            sf::Vector2f direction = segment.end - segment.start;
+            int steps = std::max(1, static_cast<int>(length(direction) / CentrelineStep));
+            for (int step = 0; step <= steps; ++step) {
+                sf::Vector2f point = segment.start + direction * (static_cast<float>(step) / steps);
+                for (const Obstacle& wall : walls.obstacles) {
+                    if (wall.checkCircleCollision(point, radius, collisionPoint, collisionNormal)) {
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+    
+    RunResult playRun(const CourseChunk& chunk, const Walls& walls, std::uint64_t seed, int run) {
+        CounterRng rng(Random::hash(seed ^ ShotSalt, chunk.index, static_cast<std::uint64_t>(run)), run);
+        const PathSegment& first = chunk.segments.front();
+        const PathSegment& last = chunk.segments.back();
+        sf::Vector2f lastDirection = (last.end - last.start) / length(last.end - last.start);
+        
+        Ball ball;
+        sf::Vector2f start = first.start + (first.end - first.start) / length(first.end - first.start) * StartInset;
+        ball.setPosition(start);
+        float radius = ball.getRadius();
+        
+        RunResult result;
+        for (int shot = 0; shot < CourseValidator::MaxShots; ++shot) {
+            result.shots = shot + 1;
+            sf::Vector2f position = ball.getPosition();
+            
+            // Aim at the next bend, or past the end of the chunk on the last stretch
+            sf::Vector2f target = last.end + lastDirection * FinishOvershoot;
+            for (std::size_t i = 0; i + 1 < chunk.segments.size(); ++i) {
+                if (chunk.segments[i].end.x > position.x + AimLead) {
+                    target = chunk.segments[i].end;
+                    break;
+                }
+            }
+            
+            // Shoot with some error, hard enough to travel about the distance to the aim point
+            sf::Vector2f toTarget = target - position;
+            float angle = std::atan2(toTarget.y, toTarget.x) + rng.uniform(-AimError, AimError) * 3.14159f / 180.f;
+            float distance = length(toTarget) * rng.uniform(MinPowerError, MaxPowerError);
+            float speed = std::min(distance * (1.f - Friction) / TimeStep, MaxShotSpeed);
+            ball.setVelocity(sf::Vector2f(std::cos(angle), std::sin(angle)) * speed);
+            
+            for (int step = 0; step < MaxStepsPerShot; ++step) {
+                ball.update(TimeStep);
+                sf::Vector2f ballPosition = ball.getPosition();
+                for (std::size_t i = 0; i < walls.obstacles.size(); ++i) {
+                    if (length(ballPosition - walls.obstacles[i].getPosition()) <= walls.reach[i] + radius) {
+                        ball.checkCollision(walls.obstacles[i]);
+                    }
+                }
+                
+                // Through the chunk, or off the course
+                ballPosition = ball.getPosition();
+                if (ballPosition.x >= last.end.x) {
+                    result.success = true;
+                    return result;
+                }
+                float offPath = EscapeMargin + radius;
+                for (const PathSegment& segment : chunk.segments) {
+                    offPath = std::min(offPath, distanceToSegment(ballPosition, segment) - segment.width / 2.f);
+                }
+                if (ballPosition.x < start.x - StartInset - EscapeMargin || offPath > EscapeMargin) {
+                    return result;
+                }
+                
+                if (ball.getVelocity() == sf::Vector2f(0.f, 0.f)) break;
+            }
+        }
+        return result;
+    }
+}
+
+CourseValidator::CourseValidator()
+    : jobSystem(nullptr)
+{
+}
+
+ChunkVerdict CourseValidator::validate(const CourseChunk& chunk, std::uint64_t seed) const {
+    ChunkVerdict verdict;
+    if (chunk.segments.empty()) return verdict;
+    
+    Walls walls;
+    walls.obstacles.reserve(chunk.walls.size());
+    walls.reach.reserve(chunk.walls.size());
+    for (const WallSpec& spec : chunk.walls) {
+        walls.obstacles.emplace_back(spec.position, spec.size, spec.color);
+        walls.obstacles.back().setRotation(spec.rotation);
+        walls.reach.push_back(length(spec.size) / 2.f);
+    }
+    
+    // No run can get through a gap narrower than the ball
+    if (isPinched(chunk, walls, Ball().getRadius())) {
+        verdict.pinched = true;
+        return verdict;
+    }
+    
+    std::array<RunResult, SampleRuns> results;
+    auto playRuns = [&](std::size_t begin, std::size_t end) {
+        for (std::size_t run = begin; run < end; ++run) {
+            results[run] = playRun(chunk, walls, seed, static_cast<int>(run));
+        }
+    };
+    if (jobSystem) {
+        jobSystem->parallelFor(SampleRuns, 1, playRuns);
+    } else {
+        playRuns(0, SampleRuns);
+    }
+    
+    int successes = 0;
+    int shots = 0;
+    for (const RunResult& result : results) {
+        if (!result.success) continue;
+        successes++;
+        shots += result.shots;
+    }
+    
+    verdict.successRate = static_cast<float>(successes) / SampleRuns;
+    verdict.meanShots = successes ? static_cast<float>(shots) / successes : 0.f;
+    verdict.passable = verdict.successRate >= MinSuccessRate;
+    
+    // Half from the runs that failed, half from the shots the others needed
+    if (verdict.passable) {
+        float failures = (1.f - verdict.successRate) / (1.f - MinSuccessRate);
+        float extraShots = (verdict.meanShots - 1.f) / (MaxShots - 1);
+        verdict.difficulty = std::clamp(0.5f * failures + 0.5f * extraShots, 0.f, 1.f);
+    }
+    return verdict;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+struct CourseChunk;
+class JobSystem;
+
+// Outcome of validating one chunk
+struct ChunkVerdict {
+    bool passable = false;
+    bool pinched = false;       // A ball doesn't fit between the walls somewhere along the path
+    float successRate = 0.f;    // Fraction of sample runs that got through
+    float meanShots = 0.f;      // Shots taken by the runs that got through
+    float difficulty = 1.f;     // 0: every run gets through in one shot, 1: barely passable or worse
+};
+
+// Checks that a generated chunk can be played by sending sample runs through
+// it with the game's own ball and wall physics. Each run is a simple player
+// that aims every shot at the next bend of the path, with random errors in
+// angle and power. A run succeeds when the ball crosses the end of the chunk
+// within a few shots and fails if the ball leaves the course. Runs are
+// spread over a job system when one is set, which pays off when the caller
+// waits for the verdict; results only depend on the chunk and the seed,
+// whatever the number of threads.
+class CourseValidator {
+public:
+    static const int SampleRuns = 16;
+    static const int MaxShots = 6;
+    static constexpr float MinSuccessRate = 0.5f;   // Runs that must get through for the chunk to pass
+    
+    CourseValidator();
+    
+    // Threads to play the runs on (nullptr to play them on the calling thread)
+    void setJobSystem(JobSystem* jobs) { jobSystem = jobs; }
+    
+    ChunkVerdict validate(const CourseChunk& chunk, std::uint64_t seed) const;
+
+private:
+    JobSystem* jobSystem;
+};
@@ -0,0 +1,89 @@
+#include "EventDispatcher.hpp"
+#include <algorithm>
+
+void EventDispatcher::add(std::type_index type, Subscription subscription) {
+    if (dispatching) {
+        pendingAdds.emplace_back(type, std::move(subscription));
+    } else {
+        handlers[type].push_back(std::move(subscription));
+    }
+}
+
+void EventDispatcher::unsubscribe(SubscriptionId id) {
+    for (auto& [type, subscriptions] : handlers) {
+        for (auto& subscription : subscriptions) {
+            if (subscription.id == id) {
+                subscription.removed = true;
+                hasRemovals = true;
+            }
+        }
+    }
+    for (auto& [type, subscription] : pendingAdds) {
+        if (subscription.id == id) subscription.removed = true;
+    }
+    
+    // Handlers may unsubscribe themselves, so only erase outside of dispatch
+    if (!dispatching) {
+        applyPending();
+    }
+}
+
+bool EventDispatcher::dispatch(const sf::Event& event) {
+    std::type_index type = event.visit([](const auto& data) {
+        return std::type_index(typeid(data));
+    });
+    
+    auto it = handlers.find(type);
+    if (it == handlers.end()) return false;
+    
+    // Map the cursor once for every region test
+    std::optional<sf::Vector2f> worldPos;
+    if (std::optional<sf::Vector2i> pixelPos = getMousePosition(event)) {
+        worldPos = mapToWorld ? mapToWorld(*pixelPos)
+                              : sf::Vector2f(static_cast<float>(pixelPos->x), static_cast<float>(pixelPos->y));
+    }
+    
+    dispatching = true;
+    bool consumed = false;
+    for (const auto& subscription : it->second) {
+        if (subscription.removed) continue;
+        if (subscription.region && worldPos && !subscription.region().contains(*worldPos)) continue;
+        
+        if (subscription.handler(event)) {
+            consumed = true;
+            break; // First receiver to handle the event takes it
+        }
+    }
+    dispatching = false;
+    
+    if (hasRemovals || !pendingAdds.empty()) {
+        applyPending();
+    }
+    return consumed;
+}
+
+std::optional<sf::Vector2i> EventDispatcher::getMousePosition(const sf::Event& event) {
+    if (const auto* pressed = event.getIf<sf::Event::MouseButtonPressed>()) return pressed->position;
+    if (const auto* released = event.getIf<sf::Event::MouseButtonReleased>()) return released->position;
+    if (const auto* moved = event.getIf<sf::Event::MouseMoved>()) return moved->position;
+    if (const auto* scrolled = event.getIf<sf::Event::MouseWheelScrolled>()) return scrolled->position;
+    return std::nullopt;
+}
+
+void EventDispatcher::applyPending() {
+    for (auto& [type, subscription] : pendingAdds) {
+        if (!subscription.removed) {
+            handlers[type].push_back(std::move(subscription));
+        }
+    }
+    pendingAdds.clear();
+    
+    if (hasRemovals) {
+        for (auto& [type, subscriptions] : handlers) {
+            subscriptions.erase(std::remove_if(subscriptions.begin(), subscriptions.end(),
+                                               [](const Subscription& subscription) { return subscription.removed; }),
+                                subscriptions.end());
+        }
+        hasRemovals = false;
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <functional>
+#include <optional>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+// Routes window events to the handlers subscribed to their type. Mouse
+// handlers can also be limited to a region, so a click only reaches the
+// receivers under the cursor. Handlers return true to consume an event and
+// stop it reaching later subscribers.
+class EventDispatcher {
+public:
+    using SubscriptionId = unsigned;
+    
+    // Current bounds of a receiver, in world coordinates
+    using Region = std::function<sf::FloatRect()>;
+    
+    // Maps a window pixel to world coordinates for region tests
+    using CoordinateMapper = std::function<sf::Vector2f(const sf::Vector2i&)>;
+    
+    EventDispatcher() = default;
+    
+    // Receive every event of type EventType (e.g. sf::Event::Resized)
+    template <typename EventType>
+    SubscriptionId subscribe(std::function<bool(const EventType&)> handler) {
+        return subscribe<EventType>(std::move(handler), nullptr);
+    }
+    
+    // Receive mouse events of type EventType only when the cursor is inside region
+    template <typename EventType>
+    SubscriptionId subscribe(std::function<bool(const EventType&)> handler, Region region) {
+        Subscription subscription;
+        subscription.id = nextId++;
+        subscription.handler = [handler](const sf::Event& event) {
+            return handler(*event.getIf<EventType>());
+        };
+        subscription.region = std::move(region);
+        
+        SubscriptionId id = subscription.id;
+        add(std::type_index(typeid(EventType)), std::move(subscription));
+        return id;
+    }
+    
+    void unsubscribe(SubscriptionId id);
+    
+    void setCoordinateMapper(CoordinateMapper mapper) { mapToWorld = std::move(mapper); }
+    
+    // Offer an event to its subscribers. Returns true if one consumed it.
+    bool dispatch(const sf::Event& event);
+    
+    // Number of handlers registered for one event type
+    template <typename EventType>
+    std::size_t getSubscriberCount() const {
+        auto it = handlers.find(std::type_index(typeid(EventType)));
+        return it != handlers.end() ? it->second.size() : 0;
+    }
+
+private:
+    struct Subscription {
+        SubscriptionId id = 0;
+        std::function<bool(const sf::Event&)> handler;
+        Region region;
+        bool removed = false;
+    };
+    
+    // Cursor position carried by mouse events, if any
+    static std::optional<sf::Vector2i> getMousePosition(const sf::Event& event);
+    
+    // Register a subscription, deferred until the current dispatch finishes
+    void add(std::type_index type, Subscription subscription);
+    
+    // Apply subscription changes made while dispatching
+    void applyPending();
+    
+    std::unordered_map<std::type_index, std::vector<Subscription>> handlers;
+    std::vector<std::pair<std::type_index, Subscription>> pendingAdds;
+    CoordinateMapper mapToWorld;
+    SubscriptionId nextId = 1;
+    bool dispatching = false;
+    bool hasRemovals = false;
+};
@@ -0,0 +1,122 @@
+#include "GhostSystem.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+GhostSystem::GhostSystem(std::size_t capacity)
+    : capacity(capacity)
+    , recordedTime(0.f)
+    , runTime(0.f)
+{
+    // Slots, vertices and recording are all allocated up front so playing never allocates
+    ghosts.reserve(capacity);
+    vertices.resize(capacity * VerticesPerGhost);
+    recording.reserve(RecordingReserve);
+    
+    for (std::size_t i = 0; i <= Sides; ++i) {
+        float angle = 2.f * 3.14159f * static_cast<float>(i) / Sides;
+        unitCircle[i] = sf::Vector2f(std::cos(angle), std::sin(angle));
+    }
+}
+
+bool GhostSystem::addGhost(GhostTrack track, const sf::Color& color) {
+    if (ghosts.size() >= capacity || track.getTickCount() == 0) return false;
+    
+    stats.trackBytes += track.getByteSize();
+    stats.trackSeconds += track.getDuration();
+    
+    Ghost ghost;
+    ghost.track = std::move(track);
+    ghost.color = color;
+    ghost.position = ghost.track.positionAt(0);
+    ghosts.push_back(std::move(ghost));
+    stats.ghosts = ghosts.size();
+    return true;
+}
+
+void GhostSystem::clearGhosts() {
+    ghosts.clear();
+    stats = GhostStats();
+}
+
+void GhostSystem::restart() {
+    runTime = 0.f;
+    recordedTime = 0.f;
+    recording.clear();
+}
+
+void GhostSystem::setState(const State& state) {
+    runTime = state.runTime;
+    recordedTime = state.recordedTime;
+    recordedPosition = state.recordedPosition;
+    recording.truncate(state.recordedTicks);
+    
+    // Cursors seek backwards on their own; decode the ghosts' positions at the restored clock
+    update(0.f);
+}
+
+void GhostSystem::update(float deltaTime) {
+    auto start = std::chrono::steady_clock::now();
+    runTime += deltaTime;
+    
+    // Ghosts sit between the two ticks around the run's clock
+    float time = runTime * GhostTrack::TickRate;
+    std::uint32_t tick = static_cast<std::uint32_t>(time);
+    float fraction = time - static_cast<float>(tick);
+    
+    stats.playing = 0;
+    stats.ticksDecoded = 0;
+    for (Ghost& ghost : ghosts) {
+        stats.ticksDecoded += ghost.track.seek(ghost.cursor, tick + 1);
+        
+        // Finished ghosts stay where their run ended
+        if (tick + 1 >= ghost.track.getTickCount()) {
+            ghost.position = ghost.cursor.position();
+            continue;
+        }
+        
+        sf::Vector2f previous = ghost.cursor.previousPosition();
+        ghost.position = previous + (ghost.cursor.position() - previous) * fraction;
+        stats.playing++;
+    }
+    
+    stats.decodeMicroseconds = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+void GhostSystem::record(const sf::Vector2f& ballPosition) {
+    if (recording.getTickCount() == 0) {
+        recordedPosition = ballPosition;
+    }
+    
+    // Frames don't line up with ticks; sampling the ball where it was at each tick keeps
+    // the movement per tick smooth, which is what the encoding relies on
+    std::uint32_t tick = static_cast<std::uint32_t>(runTime * GhostTrack::TickRate);
+    float span = runTime - recordedTime;
+    while (recording.getTickCount() <= tick) {
+        float tickTime = recording.getTickCount() / GhostTrack::TickRate;
+        float t = span > 0.f ? std::clamp((tickTime - recordedTime) / span, 0.f, 1.f) : 1.f;
+        recording.append(recordedPosition + (ballPosition - recordedPosition) * t);
+    }
+    
+    recordedPosition = ballPosition;
+    recordedTime = runTime;
+}
+
+void GhostSystem::draw(CountingRenderTarget& target) {
+    if (ghosts.empty()) return;
+    
+    // Build all ghosts into one triangle list
+    sf::Vertex* vertex = vertices.data();
+    for (const Ghost& ghost : ghosts) {
+        for (std::size_t side = 0; side < Sides; ++side) {
+            vertex[0].position = ghost.position;
+            vertex[1].position = ghost.position + unitCircle[side] * Radius;
+            vertex[2].position = ghost.position + unitCircle[side + 1] * Radius;
+            vertex[0].color = vertex[1].color = vertex[2].color = ghost.color;
+            vertex += 3;
+        }
+    }
+    
+    // Draw all ghosts in a single call
+    target.draw(vertices.data(), ghosts.size() * VerticesPerGhost, sf::PrimitiveType::Triangles);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "GhostTrack.hpp"
+#include "../utils/Colors.hpp"
+#include "../utils/MemoryTracker.hpp"
+#include "../utils/CountingRenderTarget.hpp"
+
+// Ghost playback and decoding work of the last update
+struct GhostStats {
+    std::size_t ghosts = 0;
+    std::size_t playing = 0;                // Ghosts that haven't reached the end of their track
+    std::uint32_t ticksDecoded = 0;
+    float decodeMicroseconds = 0.f;
+    std::size_t trackBytes = 0;             // Encoded size of every ghost's track
+    float trackSeconds = 0.f;               // Length of every ghost's track
+    
+    // Encoded bytes per minute of trajectory
+    float bytesPerMinute() const { return trackSeconds > 0.f ? trackBytes * 60.f / trackSeconds : 0.f; }
+};
+
+// Records the ball's run and plays ghost runs alongside it. Every ghost keeps
+// a cursor into its compressed track and decodes forwards as the run's clock
+// advances, so a frame only decodes the ticks that passed. Ghosts are drawn
+// as translucent balls, all in one draw call.
+class GhostSystem {
+public:
+    explicit GhostSystem(std::size_t capacity = 512);
+    
+    // Play track alongside the run, from the run's current time (false when every ghost slot is taken)
+    bool addGhost(GhostTrack track, const sf::Color& color = Colors::GhostColor);
+    void clearGhosts();
+    
+    // Start a new run: the clock, the recording and every ghost go back to the start
+    void restart();
+    
+    // Advance the run's clock and decode every ghost's position
+    void update(float deltaTime);
+    
+    // Sample the ball for every tick up to the run's clock, interpolating from its last position
+    void record(const sf::Vector2f& ballPosition);
+    
+    void draw(CountingRenderTarget& target);
+    
+    // The run recorded so far
+    const GhostTrack& getRecording() const { return recording; }
+    
+    // The run's clock and how much of it is recorded, for snapshots
+    struct State {
+        float runTime = 0.f;
+        float recordedTime = 0.f;
+        sf::Vector2f recordedPosition;
+        std::uint32_t recordedTicks = 0;
+    };
+    State getState() const { return {runTime, recordedTime, recordedPosition, recording.getTickCount()}; }
+    
+    // Wind the run back to a saved state: the recording loses the ticks after it
+    // and every ghost goes back to where it was then
+    void setState(const State& state);
+    
+    bool isPlaying() const { return stats.playing > 0; }
+    const GhostStats& getStats() const { return stats; }
+
+private:
+    struct Ghost {
+        GhostTrack track;
+        GhostTrack::Cursor cursor;
+        sf::Color color;
+        sf::Vector2f position;
+    };
+    
+    // Each ghost is drawn as a polygon made of triangles
+    static constexpr std::size_t Sides = 12;
+    static constexpr std::size_t VerticesPerGhost = Sides * 3;
+    static constexpr float Radius = 20.f;               // Ball's default radius
+    
+    // Seconds of recording reserved up front
+    static constexpr float RecordingReserve = 600.f;
+    
+    template <typename T>
+    using Buffer = Memory::TaggedVector<T, Memory::Tag::Ghosts>;
+    
+    std::size_t capacity;
+    Buffer<Ghost> ghosts;
+    Buffer<sf::Vertex> vertices;                        // Preallocated for every ghost slot
+    std::array<sf::Vector2f, Sides + 1> unitCircle;     // Polygon corners around the origin
+    GhostTrack recording;
+    sf::Vector2f recordedPosition;                      // Ball position at the last record()...
+    float recordedTime;                                 // ...and the run's clock then
+    float runTime;                                      // Seconds since the run started
+    GhostStats stats;
+};
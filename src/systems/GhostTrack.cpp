@@ -0,0 +1,214 @@
+#include "GhostTrack.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+namespace {
+    // Ticks whose corrections both fit in three bits take one byte; this byte starts a longer tick
+    const std::uint8_t LongTick = 64;
+    
+    // Small values of either sign map to small unsigned values: 0, -1, 1, -2... become 0, 1, 2, 3...
+    std::uint32_t zigzag(std::int32_t value) {
+        return (static_cast<std::uint32_t>(value) << 1) ^ static_cast<std::uint32_t>(value >> 31);
+    }
+    
+    std::int32_t unzigzag(std::uint32_t value) {
+        return static_cast<std::int32_t>(value >> 1) ^ -static_cast<std::int32_t>(value & 1);
+    }
+    
+    template <typename Bytes>
+    void writeVarint(Bytes& bytes, std::uint32_t value) {
+        // Seven bits per byte, high bit set on all but the last
+        while (value >= 0x80) {
+            bytes.push_back(static_cast<std::uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        bytes.push_back(static_cast<std::uint8_t>(value));
+    }
+    
+    template <typename Bytes>
+    std::uint32_t readVarint(const Bytes& bytes, std::uint32_t& offset) {
+        std::uint32_t value = 0;
+        for (int shift = 0; shift < 35 && offset < bytes.size(); shift += 7) {
+            std::uint8_t byte = bytes[offset++];
+            value |= static_cast<std::uint32_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) break;
+        }
+        return value;
+    }
+}
+
+void GhostTrack::append(const sf::Vector2f& position) {
+    std::int32_t x = static_cast<std::int32_t>(std::lround(position.x * Resolution));
+    std::int32_t y = static_cast<std::int32_t>(std::lround(position.y * Resolution));
+    std::int32_t stepX = tickCount > 0 ? x - lastX : 0;
+    std::int32_t stepY = tickCount > 0 ? y - lastY : 0;
+    
+    if (tickCount % KeyframeInterval == 0) {
+        keyframes.push_back({x, y, stepX, stepY, static_cast<std::uint32_t>(bytes.size())});
+    } else {
+        // Only the change in step is stored
+        std::uint32_t correctionX = zigzag(stepX - lastStepX);
+        std::uint32_t correctionY = zigzag(stepY - lastStepY);
+        if (correctionX < 8 && correctionY < 8) {
+            bytes.push_back(static_cast<std::uint8_t>(correctionX | correctionY << 3));
+        } else {
+            bytes.push_back(LongTick);
+            writeVarint(bytes, correctionX);
+            writeVarint(bytes, correctionY);
+        }
+    }
+    
+    lastX = x;
+    lastY = y;
+    lastStepX = stepX;
+    lastStepY = stepY;
+    tickCount++;
+}
+
+void GhostTrack::clear() {
+    keyframes.clear();
+    bytes.clear();
+    tickCount = 0;
+    lastX = lastY = lastStepX = lastStepY = 0;
+}
+
+void GhostTrack::truncate(std::uint32_t count) {
+    if (count >= tickCount) return;
+    if (count == 0) {
+        clear();
+        return;
+    }
+    
+    // The new last tick's bytes end where the dropped ticks start
+    Cursor last;
+    seek(last, count - 1);
+    keyframes.resize((count + KeyframeInterval - 1) / KeyframeInterval);
+    bytes.resize(last.offset);
+    tickCount = count;
+    
+    lastX = last.x;
+    lastY = last.y;
+    lastStepX = last.stepX;
+    lastStepY = last.stepY;
+}
+
+void GhostTrack::reserve(float seconds) {
+    std::size_t ticks = static_cast<std::size_t>(seconds * TickRate);
+    keyframes.reserve(ticks / KeyframeInterval + 1);
+    bytes.reserve(ticks * 2);
+}
+
+std::size_t GhostTrack::getByteSize() const {
+    return keyframes.size() * sizeof(Keyframe) + bytes.size();
+}
+
+std::uint32_t GhostTrack::seek(Cursor& cursor, std::uint32_t tick) const {
+    if (tickCount == 0) return 0;
+    tick = std::min(tick, tickCount - 1);
+    
+    // Going backwards or into another interval starts over from that interval's keyframe
+    std::uint32_t decoded = 0;
+    if (cursor.tick > tick || cursor.tick / KeyframeInterval != tick / KeyframeInterval) {
+        const Keyframe& keyframe = keyframes[tick / KeyframeInterval];
+        cursor.tick = tick - tick % KeyframeInterval;
+        cursor.offset = keyframe.offset;
+        cursor.x = keyframe.x;
+        cursor.y = keyframe.y;
+        cursor.stepX = keyframe.stepX;
+        cursor.stepY = keyframe.stepY;
+        decoded++;
+    }
+    
+    while (cursor.tick < tick) {
+        step(cursor);
+        decoded++;
+    }
+    return decoded;
+}
+
+void GhostTrack::step(Cursor& cursor) const {
+    std::uint32_t correctionX = 0;
+    std::uint32_t correctionY = 0;
+    std::uint8_t first = cursor.offset < bytes.size() ? bytes[cursor.offset++] : 0;
+    if (first < LongTick) {
+        correctionX = first & 7;
+        correctionY = first >> 3;
+    } else {
+        correctionX = readVarint(bytes, cursor.offset);
+        correctionY = readVarint(bytes, cursor.offset);
+    }
+    
+    cursor.stepX += unzigzag(correctionX);
+    cursor.stepY += unzigzag(correctionY);
+    cursor.x += cursor.stepX;
+    cursor.y += cursor.stepY;
+    cursor.tick++;
+}
+
+sf::Vector2f GhostTrack::positionAt(std::uint32_t tick) const {
+    Cursor cursor;
+    seek(cursor, tick);
+    return cursor.position();
+}
+
+bool GhostTrack::save(const std::string& filename) const {
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+    
+    Header header = {};
+    header.magic = Magic;
+    header.version = Version;
+    header.tickCount = tickCount;
+    header.keyframeCount = static_cast<std::uint32_t>(keyframes.size());
+    header.byteCount = static_cast<std::uint32_t>(bytes.size());
+    header.keyframeInterval = KeyframeInterval;
+    
+    out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    out.write(reinterpret_cast<const char*>(keyframes.data()),
+              static_cast<std::streamsize>(keyframes.size() * sizeof(Keyframe)));
+    out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return static_cast<bool>(out);
+}
+
+bool GhostTrack::load(const std::string& filename) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in) return false;
+    
+    // Validate the header before trusting any of its counts
+    Header header = {};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(Header))) return false;
+    if (header.magic != Magic || header.version != Version || header.keyframeInterval != KeyframeInterval) {
+        return false;
+    }
+    if (header.keyframeCount != (header.tickCount + KeyframeInterval - 1) / KeyframeInterval) {
+        return false;
+    }
+    
+    Buffer<Keyframe> fileKeyframes(header.keyframeCount);
+    Buffer<std::uint8_t> fileBytes(header.byteCount);
+    in.read(reinterpret_cast<char*>(fileKeyframes.data()),
+            static_cast<std::streamsize>(fileKeyframes.size() * sizeof(Keyframe)));
+    in.read(reinterpret_cast<char*>(fileBytes.data()), static_cast<std::streamsize>(fileBytes.size()));
+    if (!in) return false;
+    
+    // Every interval must start inside the encoded ticks
+    std::uint32_t previousOffset = 0;
+    for (const Keyframe& keyframe : fileKeyframes) {
+        if (keyframe.offset < previousOffset || keyframe.offset > header.byteCount) return false;
+        previousOffset = keyframe.offset;
+    }
+    
+    keyframes = std::move(fileKeyframes);
+    bytes = std::move(fileBytes);
+    tickCount = header.tickCount;
+    
+    // Continue from the last tick if more are appended
+    Cursor last;
+    seek(last, tickCount > 0 ? tickCount - 1 : 0);
+    lastX = last.x;
+    lastY = last.y;
+    lastStepX = last.stepX;
+    lastStepY = last.stepY;
+    return true;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "../utils/MemoryTracker.hpp"
+
+// Path of a ball sampled at a fixed tick rate, compressed for ghost runs.
+// Positions are quantised to 1/Resolution pixel. Each tick stores the error
+// of a constant-velocity prediction (position plus the last step). For a
+// rolling or resting ball both errors are tiny and share one byte; larger ones
+// (shots, bounces) follow a marker byte as zigzag varints.
+// Every KeyframeInterval ticks the absolute position and step are stored
+// instead, so playback can start anywhere after decoding at most one interval.
+//
+// Ghost file format (little-endian):
+//
+//   Header
+//   Keyframe[keyframeCount]
+//   uint8[byteCount]                 encoded ticks
+class GhostTrack {
+public:
+    static constexpr float TickRate = 60.f;             // Ticks per second
+    static constexpr float Resolution = 8.f;            // Quantisation steps per pixel
+    static const std::uint32_t KeyframeInterval = 64;   // Ticks per keyframe
+    
+    struct Keyframe {
+        std::int32_t x;
+        std::int32_t y;
+        std::int32_t stepX;         // Movement from the tick before
+        std::int32_t stepY;
+        std::uint32_t offset;       // First byte of the ticks after this one
+    };
+    
+    // Decoding position in a track, for playing it forwards a tick at a time
+    struct Cursor {
+        std::uint32_t tick = UINT32_MAX;    // Not positioned yet
+        std::uint32_t offset = 0;
+        std::int32_t x = 0;
+        std::int32_t y = 0;
+        std::int32_t stepX = 0;
+        std::int32_t stepY = 0;
+        
+        sf::Vector2f position() const { return toPixels(x, y); }
+        sf::Vector2f previousPosition() const { return toPixels(x - stepX, y - stepY); }
+    };
+    
+    GhostTrack() = default;
+    
+    // Add the position of the next tick
+    void append(const sf::Vector2f& position);
+    void clear();
+    
+    // Drop every tick from tick count on, so appending continues from the one before
+    void truncate(std::uint32_t count);
+    
+    // Room for seconds of recording, so appending doesn't allocate
+    void reserve(float seconds);
+    
+    std::uint32_t getTickCount() const { return tickCount; }
+    float getDuration() const { return tickCount / TickRate; }
+    
+    // Encoded size, keyframes included
+    std::size_t getByteSize() const;
+    
+    // Move cursor to tick (clamped to the last one), decoding forwards from where it is
+    // or from the nearest keyframe before tick. Returns the number of ticks decoded.
+    std::uint32_t seek(Cursor& cursor, std::uint32_t tick) const;
+    
+    // Position at tick (seeks from a keyframe; use a cursor for playback)
+    sf::Vector2f positionAt(std::uint32_t tick) const;
+    
+    bool save(const std::string& filename) const;
+    bool load(const std::string& filename);
+    
+    static sf::Vector2f toPixels(std::int32_t x, std::int32_t y) {
+        return {x / Resolution, y / Resolution};
+    }
+
+private:
+    struct Header {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t tickCount;
+        std::uint32_t keyframeCount;
+        std::uint32_t byteCount;
+        std::uint32_t keyframeInterval;
+    };
+    
+    static const std::uint32_t Magic = 0x4847474D;    // "MGGH"
+    static const std::uint32_t Version = 1;
+    
+    // Decode the tick after cursor's
+    void step(Cursor& cursor) const;
+    
+    template <typename T>
+    using Buffer = Memory::TaggedVector<T, Memory::Tag::Ghosts>;
+    
+    Buffer<Keyframe> keyframes;
+    Buffer<std::uint8_t> bytes;
+    std::uint32_t tickCount = 0;
+    
+    // Last appended tick, to predict the next one
+    std::int32_t lastX = 0;
+    std::int32_t lastY = 0;
+    std::int32_t lastStepX = 0;
+    std::int32_t lastStepY = 0;
+};
@@ -1,65 +1,34 @@
 #include "InputHandler.hpp"
-#include "../utils/Entity.hpp"
+#include "../core/LatencyTracker.hpp"
 
 InputHandler::InputHandler(sf::RenderWindow& window) 
-    : window(window) {
+    : window(window)
+    , latencyTracker(nullptr) {
+    // Mouse regions are tested in world coordinates
+    dispatcher.setCoordinateMapper([this](const sf::Vector2i& pixelPos) {
+        return mapPixelToCoords(pixelPos);
+    });
 }
 
-bool InputHandler::processEvents(std::vector<std::unique_ptr<Entity>>& entities) {
+void InputHandler::processEvents() {
     while (std::optional<sf::Event> event = window.pollEvent()) {
-        // Handle window close
-        if (event->is<sf::Event::Closed>()) {
-            window.close();
-            return false; // Signal to stop the game
-        }
-        
-        // Handle window resize
-        if (const auto* resized = event->getIf<sf::Event::Resized>()) {
-            // Window was resized
-            unsigned int width = resized->size.x;
-            unsigned int height = resized->size.y;
-            // Handle resize if needed
-        }
-        
-        // Handle mouse press
-        if (event->is<sf::Event::MouseButtonPressed>() && 
-            sf::Mouse::isButtonPressed(sf::Mouse::Button::Left)) {
-            sf::Vector2i mousePixelPos = sf::Mouse::getPosition(window);
-            sf::Vector2f mousePos = mapPixelToCoords(mousePixelPos);
-            
-            for (auto& entity : entities) {
-                if (entity->handleMousePress(mousePos)) {
-                    break; // Break after first entity handles the event
-                }
-            }
-        }
-        
-        // Handle mouse release
-        if (event->is<sf::Event::MouseButtonReleased>()) {
-            sf::Vector2i mousePixelPos = sf::Mouse::getPosition(window);
-            sf::Vector2f mousePos = mapPixelToCoords(mousePixelPos);
-            
-            for (auto& entity : entities) {
-                if (entity->handleMouseRelease(mousePos)) {
-                    break; // Break after first entity handles the event
-                }
-            }
-        }
-        
-        // Handle mouse move
-        if (event->is<sf::Event::MouseMoved>()) {
-            sf::Vector2i mousePixelPos = sf::Mouse::getPosition(window);
-            sf::Vector2f mousePos = mapPixelToCoords(mousePixelPos);
-            
-            for (auto& entity : entities) {
-                if (entity->handleMouseMove(mousePos)) {
-                    break; // Break after first entity handles the event
-                }
-            }
-        }
+        handleEvent(*event);
+    }
+}
+
+void InputHandler::waitEvents() {
+    if (std::optional<sf::Event> event = window.waitEvent()) {
+        handleEvent(*event);
+    }
+    processEvents();
+}
+
+void InputHandler::handleEvent(const sf::Event& event) {
+    // Stamp on arrival; only events a handler acted on count towards latency
+    auto arrival = LatencyTracker::Clock::now();
+    if (dispatcher.dispatch(event) && latencyTracker) {
+        latencyTracker->recordInput(event, arrival);
     }
-    
-    return true;
 }
 
 sf::Vector2f InputHandler::mapPixelToCoords(const sf::Vector2i& pixelPos) const {
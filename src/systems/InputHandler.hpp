@@ -4,8 +4,9 @@
 #include <vector>
 #include <memory>
 #include <optional>
+#include "EventDispatcher.hpp"
 
-class Entity;
+class LatencyTracker;
 
 // Input handler responsible for processing all user input
 class InputHandler {
@@ -13,12 +14,26 @@ public:
     InputHandler(sf::RenderWindow& window);
     ~InputHandler() = default;
     
-    // Process all input events
-    bool processEvents(std::vector<std::unique_ptr<Entity>>& entities);
+    // Drain the window's event queue into the dispatcher (the only place events are polled)
+    void processEvents();
+    
+    // Block until at least one event arrives, then dispatch everything queued
+    void waitEvents();
+    
+    // Register handlers here to receive events
+    EventDispatcher& getDispatcher() { return dispatcher; }
+    
+    // Report consumed input events for latency measurement (nullptr to disable)
+    void setLatencyTracker(LatencyTracker* tracker) { latencyTracker = tracker; }
     
     // Map pixel coords to world coordinates
     sf::Vector2f mapPixelToCoords(const sf::Vector2i& pixelPos) const;
     
 private:
+    // Dispatch one event and report it for latency measurement if it was consumed
+    void handleEvent(const sf::Event& event);
+    
     sf::RenderWindow& window;
+    EventDispatcher dispatcher;
+    LatencyTracker* latencyTracker;
 }; 
\ No newline at end of file
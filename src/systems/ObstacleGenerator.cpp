@@ -1,85 +1,370 @@
 #include "ObstacleGenerator.hpp"
+#include "CourseFile.hpp"
+#include "../core/JobSystem.hpp"
 #include "../entities/Obstacle.hpp"
 #include "../utils/Colors.hpp"
+#include "../utils/Random.hpp"
+#include "../utils/FrameArena.hpp"
 #include <chrono>
 #include <cmath>
 #include <algorithm>
 
+namespace {
+    // Salts that give each kind of draw its own independent random stream
+    const std::uint64_t MeanderSalt = 0x6D65616E646572ull;
+    const std::uint64_t BoundarySalt = 0x626F756E64617279ull;
+    const std::uint64_t SegmentSalt = 0x7365676D656E74ull;
+    const std::uint64_t WallSalt = 0x77616C6Cull;
+    
+    // Number of boundaries between two control points of the large-scale meander
+    const int MeanderPeriod = 8;
+    
+    // Horizontal jitter of interior path nodes, as a fraction of the segment spacing
+    const float NodeJitter = 0.15f;
+    
+    int floorDiv(int value, int divisor) {
+        int quotient = value / divisor;
+        return (value % divisor != 0 && value < 0) ? quotient - 1 : quotient;
+    }
+}
+
 ObstacleGenerator::ObstacleGenerator()
-    : lastGenerationPos(0.f, 0.f)
-    , currentPathEnd(300.f, 300.f)
-    , currentPathDirection(1.f, 0.f)  // Initial direction: right
-    , currentPathWidth(200.f)         // Initial path width
+    : ObstacleGenerator(static_cast<std::uint64_t>(
+          std::chrono::system_clock::now().time_since_epoch().count()))  // Time-based seed
+{
+}
+
+ObstacleGenerator::ObstacleGenerator(std::uint64_t seed)
+    : seed(seed)
+    , course(nullptr)
+    , frameArena(nullptr)
+    , lastGenerationPos(0.f, 0.f)
+    , requiredChunk(0)
+    , jobSystem(nullptr)
+    , validationJobs(0)
+    , courseOrigin(500.f, 300.f)      // 200px to the right of the ball's spawn point
+    , segmentsPerChunk(3)
+    , segmentSpacing(350.f)
     , obstacleGenerationDistance(300.f)
-    , minObstacleDistance(100.f)
-    , maxObstacleCount(100)
+    , chunksAhead(2)
+    , chunksBehind(1)
     , maxPathTurnAngle(45.f)
     , minPathSegmentLength(200.f)
     , maxPathSegmentLength(500.f)
 {
-    // Initialize random number generator with time-based seed
-    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-    rng.seed(seed);
+    // Derive the spacing from the allowed segment lengths
+    segmentSpacing = (minPathSegmentLength + maxPathSegmentLength) / 2.f;
+}
+
+ObstacleGenerator::~ObstacleGenerator() {
+    // Jobs in flight refer to this generator
+    std::unique_lock<std::mutex> lock(layoutMutex);
+    validationDone.wait(lock, [this]() { return validationJobs == 0; });
+}
+
+void ObstacleGenerator::setJobSystem(JobSystem* jobs) {
+    jobSystem = jobs;
+    validator.setJobSystem(jobs);
 }
 
-void ObstacleGenerator::generateObstacles(const sf::Vector2f& ballPosition, 
-                                        std::vector<std::unique_ptr<Entity>>& entities,
-                                        const std::vector<Obstacle*>& existingObstacles) {
-    // Don't generate if we already have too many obstacles
-    if (existingObstacles.size() >= maxObstacleCount) return;
+void ObstacleGenerator::scheduleChunks(const sf::Vector2f& ballPosition,
+                                       std::vector<std::unique_ptr<Entity>>& entities) {
+    // Keep a window of chunks around the ball (the course starts at chunk 0)
+    int ballChunk = chunkIndexAt(ballPosition);
+    int firstChunk = std::max(0, ballChunk - chunksBehind);
+    int lastChunk = std::max(0, ballChunk + chunksAhead);
+    
+    // Drop chunks the ball has left; they can be rebuilt from the seed later
+    evictChunks(firstChunk, lastChunk, entities);
     
-    // Initialize the path start if this is the first generation
-    if (lastGenerationPos == sf::Vector2f(0.f, 0.f)) {
-        currentPathEnd = ballPosition + sf::Vector2f(200.f, 0.f);
-        currentPathDirection = sf::Vector2f(1.f, 0.f);
+    // Queue any missing chunk in the window
+    pendingChunks.clear();
+    for (int chunk = firstChunk; chunk <= lastChunk; ++chunk) {
+        if (liveChunks.count(chunk) == 0) {
+            pendingChunks.push_back(chunk);
+        }
     }
     
-    // Generate new path segments ahead of the ball
-    std::vector<PathSegment> newSegments = generatePathSegments(ballPosition);
+    // Nearest chunks first, preferring the ones ahead of the ball
+    auto priority = [ballChunk](int chunk) {
+        return chunk >= ballChunk ? (chunk - ballChunk) * 2 : (ballChunk - chunk) * 2 + 1;
+    };
+    std::sort(pendingChunks.begin(), pendingChunks.end(),
+        [&](int a, int b) { return priority(a) < priority(b); });
     
-    // Create wall obstacles from path segments
-    createWallsFromPath(newSegments, entities, ballPosition, existingObstacles);
+    // The ball must never run out of course
+    requiredChunk = std::max(0, ballChunk + 1);
+    
+    // Validate in the background so the chunks are ready by the time they are built
+    for (int chunk : pendingChunks) {
+        requestValidation(chunk);
+    }
     
     // Update the last generation position
     updateLastGenerationPosition(ballPosition);
 }
 
-std::vector<PathSegment> ObstacleGenerator::generatePathSegments(const sf::Vector2f& ballPosition) {
-    std::vector<PathSegment> segments;
-    
-    // Random distributions for path properties
-    std::uniform_real_distribution<float> angleDist(-maxPathTurnAngle, maxPathTurnAngle);
-    std::uniform_real_distribution<float> lengthDist(minPathSegmentLength, maxPathSegmentLength);
-    std::uniform_real_distribution<float> widthDist(180.f, 250.f);
+void ObstacleGenerator::generateObstacles(std::vector<std::unique_ptr<Entity>>& entities,
+                                        float budgetMicroseconds) {
+    auto sliceStart = std::chrono::steady_clock::now();
+    auto elapsedMicroseconds = [&]() {
+        return std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - sliceStart).count();
+    };
     
-    // Add 2-3 new path segments
-    int segmentCount = 3;
-    sf::Vector2f segmentStart = currentPathEnd;
-    sf::Vector2f currentDir = currentPathDirection;
+    stats.wallsThisFrame = 0;
     
-    for (int i = 0; i < segmentCount; i++) {
-        // Determine segment properties
-        float segmentLength = lengthDist(rng);
-        float turnAngle = angleDist(rng);
-        float pathWidth = widthDist(rng);
+    while (hasPendingWork()) {
+        // Next chunk to start: the first one that is validated or can't wait
+        auto next = pendingChunks.end();
+        if (activeJob.chunk == NoChunk) {
+            next = std::find_if(pendingChunks.begin(), pendingChunks.end(), [this](int chunk) {
+                return chunk <= requiredChunk || isChunkReady(chunk);
+            });
+            if (next == pendingChunks.end()) break;     // Waiting for validation
+        }
+        
+        // Required chunks ignore the budget, everything else stops when it runs out
+        int nextChunk = activeJob.chunk != NoChunk ? activeJob.chunk : *next;
+        if (nextChunk > requiredChunk && elapsedMicroseconds() >= budgetMicroseconds) {
+            break;
+        }
         
-        // Apply rotation to direction vector using a rotation matrix
-        float angleRad = turnAngle * 3.14159f / 180.f;
-        float cos_a = std::cos(angleRad);
-        float sin_a = std::sin(angleRad);
+        // One unit of work: start the next chunk or add one wall
+        if (activeJob.chunk == NoChunk) {
+            startChunk(nextChunk);
+            pendingChunks.erase(next);
+        } else {
+            spawnNextWall(entities);
+            stats.wallsThisFrame++;
+        }
+    }
+    
+    // Report the remaining backlog and the time spent
+    stats.frameMicroseconds = elapsedMicroseconds();
+    stats.maxFrameMicroseconds = std::max(stats.maxFrameMicroseconds, stats.frameMicroseconds);
+    if (stats.frameMicroseconds > budgetMicroseconds) {
+        stats.framesOverBudget++;
+    }
+    stats.backlogChunks = pendingChunks.size() + (activeJob.chunk != NoChunk ? 1 : 0);
+    stats.backlogWalls = activeJob.chunk != NoChunk ? activeJob.wallCount - activeJob.nextWall : 0;
+}
+
+void ObstacleGenerator::clearChunks(std::vector<std::unique_ptr<Entity>>& entities) {
+    // An empty window evicts everything
+    pendingChunks.clear();
+    evictChunks(0, -1, entities);
+}
+
+CourseChunk ObstacleGenerator::generateChunk(int chunkIndex) const {
+    return buildChunk(chunkIndex, chunkLayout(chunkIndex).variant);
+}
+
+CourseChunk ObstacleGenerator::buildChunk(int chunkIndex, int variant) const {
+    CourseChunk chunk;
+    chunk.index = chunkIndex;
+    chunk.segments.resize(segmentsPerChunk);
+    generatePathSegments(chunkIndex, variant, chunk.segments.data());
+    chunk.walls.resize(chunk.segments.size() * 2);
+    createWallsFromPath(chunkIndex, chunk.segments.data(), chunk.segments.size(), chunk.walls.data());
+    return chunk;
+}
+
+ObstacleGenerator::ChunkLayout ObstacleGenerator::chunkLayout(int chunkIndex) const {
+    {
+        std::lock_guard<std::mutex> lock(layoutMutex);
+        auto it = layouts.find(chunkIndex);
+        if (it != layouts.end()) return it->second;
+    }
+    
+    // Validate outside the lock; a layout cached in the meantime wins
+    ChunkLayout layout = validateLayout(chunkIndex, validator);
+    std::lock_guard<std::mutex> lock(layoutMutex);
+    return layouts.emplace(chunkIndex, layout).first->second;
+}
+
+ObstacleGenerator::ChunkLayout ObstacleGenerator::validateLayout(int chunkIndex,
+                                                                 const CourseValidator& validator) const {
+    ChunkLayout layout;
+    for (layout.variant = 0; layout.variant <= StraightLayout; ++layout.variant) {
+        layout.verdict = validator.validate(buildChunk(chunkIndex, layout.variant), seed);
+        if (layout.verdict.passable) break;
+    }
+    layout.variant = std::min(layout.variant, static_cast<int>(StraightLayout));
+    return layout;
+}
+
+void ObstacleGenerator::requestValidation(int chunkIndex) {
+    if (course && course->findChunk(chunkIndex)) return;
+    
+    if (!jobSystem) {
+        chunkLayout(chunkIndex);
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(layoutMutex);
+        if (layouts.count(chunkIndex) != 0 || queuedValidations.count(chunkIndex) != 0 ||
+            runningValidations.count(chunkIndex) != 0) return;
+        queuedValidations.insert(chunkIndex);
+        validationJobs++;
+    }
+    
+    jobSystem->submit([this, chunkIndex]() {
+        {
+            // The chunk was taken over by the main thread while this job was queued
+            std::lock_guard<std::mutex> lock(layoutMutex);
+            if (queuedValidations.erase(chunkIndex) == 0) {
+                validationJobs--;
+                validationDone.notify_all();
+                return;
+            }
+            runningValidations.insert(chunkIndex);
+        }
         
-        sf::Vector2f newDir;
-        newDir.x = currentDir.x * cos_a - currentDir.y * sin_a;
-        newDir.y = currentDir.x * sin_a + currentDir.y * cos_a;
+        ChunkLayout layout = validateLayout(chunkIndex, jobValidator);
         
-        // Normalize direction vector
-        float length = std::sqrt(newDir.x * newDir.x + newDir.y * newDir.y);
-        if (length > 0) {
-            newDir = newDir / length;
+        std::lock_guard<std::mutex> lock(layoutMutex);
+        layouts.emplace(chunkIndex, layout);
+        runningValidations.erase(chunkIndex);
+        validationJobs--;
+        validationDone.notify_all();
+    });
+}
+
+bool ObstacleGenerator::isChunkReady(int chunkIndex) const {
+    if (course && course->findChunk(chunkIndex)) return true;
+    
+    std::lock_guard<std::mutex> lock(layoutMutex);
+    return layouts.count(chunkIndex) != 0;
+}
+
+ObstacleGenerator::ChunkLayout ObstacleGenerator::settleLayout(int chunkIndex) {
+    {
+        std::unique_lock<std::mutex> lock(layoutMutex);
+        if (layouts.count(chunkIndex) == 0) {
+            // The ball got here before the verdict: wait for a validation that is running,
+            // take over one that hasn't started rather than queue behind other chunks
+            stats.validationStalls++;
+            if (runningValidations.count(chunkIndex) != 0) {
+                validationDone.wait(lock, [&]() { return runningValidations.count(chunkIndex) == 0; });
+            } else {
+                queuedValidations.erase(chunkIndex);
+            }
+        }
+    }
+    
+    // Cached by now, unless it is validated here
+    ChunkLayout layout = chunkLayout(chunkIndex);
+    stats.rejectedLayouts += static_cast<std::uint64_t>(layout.variant);
+    return layout;
+}
+
+int ObstacleGenerator::getBuiltLayout(int chunkIndex) const {
+    if (course && course->findChunk(chunkIndex)) return CourseFileLayout;
+    
+    std::lock_guard<std::mutex> lock(layoutMutex);
+    auto it = layouts.find(chunkIndex);
+    return it != layouts.end() ? it->second.variant : NoLayout;
+}
+
+CourseChunk ObstacleGenerator::chunkAt(int chunkIndex) const {
+    if (course) {
+        if (const CourseFormat::ChunkEntry* entry = course->findChunk(chunkIndex)) {
+            return course->readChunk(*entry);
+        }
+    }
+    return generateChunk(chunkIndex);
+}
+
+int ObstacleGenerator::chunkIndexAt(const sf::Vector2f& position) const {
+    float chunkLength = segmentSpacing * segmentsPerChunk;
+    return static_cast<int>(std::floor((position.x - courseOrigin.x) / chunkLength));
+}
+
+sf::Vector2f ObstacleGenerator::boundaryPoint(int boundaryIndex) const {
+    float chunkLength = segmentSpacing * segmentsPerChunk;
+    
+    // Keep every segment within half the turn angle of +x, so the course
+    // never doubles back and two consecutive segments never turn by more
+    // than maxPathTurnAngle. The boundaries use half of that slope budget,
+    // interior nodes the rest.
+    float maxSlope = std::tan(maxPathTurnAngle / 2.f * 3.14159f / 180.f);
+    float meanderAmplitude = MeanderPeriod * chunkLength * maxSlope / 8.f;
+    float boundaryJitter = chunkLength * maxSlope / 8.f;
+    
+    // Large-scale meander: random control points, linearly interpolated
+    auto meander = [&](int boundary) {
+        int cell = floorDiv(boundary, MeanderPeriod);
+        float t = static_cast<float>(boundary - cell * MeanderPeriod) / MeanderPeriod;
+        float from = CounterRng(seed ^ MeanderSalt, cell).uniform(-1.f, 1.f);
+        float to = CounterRng(seed ^ MeanderSalt, cell + 1).uniform(-1.f, 1.f);
+        return (from + (to - from) * t) * meanderAmplitude;
+    };
+    
+    // Small per-boundary jitter (none at the start so the course begins in front of the ball)
+    float jitter = 0.f;
+    if (boundaryIndex != 0) {
+        jitter = CounterRng(seed ^ BoundarySalt, boundaryIndex).uniform(-1.f, 1.f) * boundaryJitter;
+    }
+    
+    return {
+        courseOrigin.x + boundaryIndex * chunkLength,
+        courseOrigin.y + meander(boundaryIndex) - meander(0) + jitter
+    };
+}
+
+float ObstacleGenerator::boundaryWidth(int boundaryIndex) const {
+    // Draw after the jitter value of the same stream
+    CounterRng boundaryRng(seed ^ BoundarySalt, boundaryIndex);
+    boundaryRng.next();
+    return boundaryRng.uniform(180.f, 250.f);
+}
+
+void ObstacleGenerator::generatePathSegments(int chunkIndex, int variant, PathSegment* segments) const {
+    // Variant 0 keeps the stream of the original layout, the others get their own
+    std::uint64_t variantSeed = seed ^ SegmentSalt;
+    if (variant > 0) {
+        variantSeed = Random::hash(variantSeed, chunkIndex, static_cast<std::uint64_t>(variant));
+    }
+    CounterRng rng(variantSeed, chunkIndex);
+    bool straight = variant == StraightLayout;
+    
+    // Both ends are shared with the neighbouring chunks so the course joins up
+    sf::Vector2f chunkStart = boundaryPoint(chunkIndex);
+    sf::Vector2f chunkEnd = boundaryPoint(chunkIndex + 1);
+    float chordSlope = (chunkEnd.y - chunkStart.y) / (chunkEnd.x - chunkStart.x);
+    
+    // Lateral offset of interior nodes, bounded by the remaining slope budget
+    float maxSlope = std::tan(maxPathTurnAngle / 2.f * 3.14159f / 180.f);
+    float minStep = segmentSpacing * (1.f - 2.f * NodeJitter);
+    float lateralJitter = minStep * maxSlope / 4.f;
+    
+    sf::Vector2f segmentStart = chunkStart;
+    
+    for (int i = 0; i < segmentsPerChunk; i++) {
+        // Determine the end node of this segment
+        sf::Vector2f segmentEnd = chunkEnd;
+        if (i < segmentsPerChunk - 1) {
+            float x = chunkStart.x + (i + 1) * segmentSpacing
+                    + rng.uniform(-NodeJitter, NodeJitter) * segmentSpacing;
+            float y = chunkStart.y + chordSlope * (x - chunkStart.x)
+                    + rng.uniform(-lateralJitter, lateralJitter);
+            segmentEnd = sf::Vector2f(x, y);
+            
+            // The straight layout keeps the nodes evenly spaced on the chord
+            if (straight) {
+                x = chunkStart.x + (i + 1) * segmentSpacing;
+                segmentEnd = sf::Vector2f(x, chunkStart.y + chordSlope * (x - chunkStart.x));
+            }
         }
         
-        // Calculate segment end point
-        sf::Vector2f segmentEnd = segmentStart + newDir * segmentLength;
+        // Segments touching a boundary take its width so walls line up across chunks
+        float pathWidth = straight ? 250.f : rng.uniform(180.f, 250.f);
+        if (i == 0) {
+            pathWidth = boundaryWidth(chunkIndex);
+        } else if (i == segmentsPerChunk - 1) {
+            pathWidth = boundaryWidth(chunkIndex + 1);
+        }
         
         // Create the path segment
         PathSegment segment;
@@ -88,37 +373,26 @@ std::vector<PathSegment> ObstacleGenerator::generatePathSegments(const sf::Vecto
         segment.width = pathWidth;
         
         // Add the segment to the result
-        segments.push_back(segment);
+        segments[i] = segment;
         
         // Prepare for the next segment
         segmentStart = segmentEnd;
-        currentDir = newDir;
     }
-    
-    // Update the path state
-    currentPathEnd = segmentStart;
-    currentPathDirection = currentDir;
-    currentPathWidth = segments.back().width;
-    
-    return segments;
 }
 
-void ObstacleGenerator::createWallsFromPath(const std::vector<PathSegment>& segments, 
-                                           std::vector<std::unique_ptr<Entity>>& entities,
-                                           const sf::Vector2f& ballPosition,
-                                           const std::vector<Obstacle*>& existingObstacles) {
+void ObstacleGenerator::createWallsFromPath(int chunkIndex, const PathSegment* segments,
+                                            std::size_t segmentCount, WallSpec* walls) const {
     // Colors for obstacles
     sf::Color wallColors[] = {
         Colors::LightBrown,
         Colors::DarkBrown,
         Colors::Gray
     };
-    std::uniform_int_distribution<int> colorDist(0, 2);
+    CounterRng colorRng(seed ^ WallSalt, chunkIndex);
     
-    // Keep track of the ball radius for collision checking
-    float ballRadius = 20.f;
-    
-    for (const auto& segment : segments) {
+    for (std::size_t i = 0; i < segmentCount; ++i) {
+        const PathSegment& segment = segments[i];
+        
         // Calculate the normalized direction vector of the segment
         sf::Vector2f segmentDir = segment.end - segment.start;
         float segmentLength = std::sqrt(segmentDir.x * segmentDir.x + segmentDir.y * segmentDir.y);
@@ -139,75 +413,136 @@ void ObstacleGenerator::createWallsFromPath(const std::vector<PathSegment>& segm
         // Create wall thickness
         float wallThickness = 20.f;
         
-        // Create the left wall
-        sf::Vector2f leftWallPos = (leftStart + leftEnd) / 2.f;
-        sf::Vector2f leftWallSize(segmentLength, wallThickness);
-        
-        // Rotate the left wall
+        // Both walls share the segment's rotation
         float angle = std::atan2(segmentDir.y, segmentDir.x) * 180.f / 3.14159f;
         
-        // Pick a random color
-        sf::Color leftColor = wallColors[colorDist(rng)];
-        
-        // Create the obstacle entity
-        auto leftWall = std::make_unique<Obstacle>(leftWallPos, leftWallSize, leftColor);
-        
-        // Set the rotation of the left wall
-        leftWall->setRotation(angle);
+        // Create the left wall
+        WallSpec leftWall;
+        leftWall.position = (leftStart + leftEnd) / 2.f;
+        leftWall.size = sf::Vector2f(segmentLength, wallThickness);
+        leftWall.rotation = angle;
+        leftWall.color = wallColors[colorRng.uniformInt(0, 2)];
+        walls[i * 2] = leftWall;
         
         // Create the right wall
-        sf::Vector2f rightWallPos = (rightStart + rightEnd) / 2.f;
-        sf::Vector2f rightWallSize(segmentLength, wallThickness);
-        
-        // Pick a random color
-        sf::Color rightColor = wallColors[colorDist(rng)];
-        
-        // Create the obstacle entity
-        auto rightWall = std::make_unique<Obstacle>(rightWallPos, rightWallSize, rightColor);
-        
-        // Set the rotation of the right wall
-        rightWall->setRotation(angle);
-        
-        // Add obstacles to the entities list
-        if (isValidObstaclePosition(leftWallPos, leftWallSize, ballPosition, ballRadius, existingObstacles)) {
-            entities.push_back(std::move(leftWall));
-        }
+        WallSpec rightWall;
+        rightWall.position = (rightStart + rightEnd) / 2.f;
+        rightWall.size = sf::Vector2f(segmentLength, wallThickness);
+        rightWall.rotation = angle;
+        rightWall.color = wallColors[colorRng.uniformInt(0, 2)];
+        walls[i * 2 + 1] = rightWall;
+    }
+}
+
+void ObstacleGenerator::startChunk(int chunkIndex) {
+    activeJob = ChunkJob();
+    activeJob.chunk = chunkIndex;
+    
+    // Build colliders straight from the mapped arrays when the course file has this chunk
+    const CourseFormat::ChunkEntry* entry = course ? course->findChunk(chunkIndex) : nullptr;
+    if (entry) {
+        activeJob.fromFile = true;
+        activeJob.firstWall = entry->firstWall;
+        activeJob.wallCount = entry->wallCount;
+    } else {
+        // Validation was started when the chunk was queued
+        ChunkLayout layout = settleLayout(chunkIndex);
         
-        if (isValidObstaclePosition(rightWallPos, rightWallSize, ballPosition, ballRadius, existingObstacles)) {
-            entities.push_back(std::move(rightWall));
-        }
+        // The path is only needed to place the walls, so it lives in the frame arena
+        FrameVector<PathSegment> segments(segmentsPerChunk, PathSegment(), frameArena);
+        generatePathSegments(chunkIndex, layout.variant, segments.data());
+        activeJob.walls.resize(segments.size() * 2);
+        createWallsFromPath(chunkIndex, segments.data(), segments.size(), activeJob.walls.data());
+        activeJob.wallCount = static_cast<std::uint32_t>(activeJob.walls.size());
     }
+    
+    // The chunk counts as live from its first wall so eviction also removes partial chunks
+    liveChunks.insert(chunkIndex);
 }
 
-bool ObstacleGenerator::isValidObstaclePosition(const sf::Vector2f& pos, 
-                                              const sf::Vector2f& size, 
-                                              const sf::Vector2f& ballPosition,
-                                              float ballRadius,
-                                              const std::vector<Obstacle*>& obstacles) {
-    // Don't generate too close to the ball
-    float distToBall = std::hypot(pos.x - ballPosition.x, pos.y - ballPosition.y);
-    if (distToBall < minObstacleDistance + ballRadius) {
-        return false;
+void ObstacleGenerator::spawnNextWall(std::vector<std::unique_ptr<Entity>>& entities) {
+    std::unique_ptr<Obstacle> obstacle;
+    
+    if (activeJob.fromFile) {
+        std::uint32_t i = activeJob.firstWall + activeJob.nextWall;
+        const CourseFormat::Vec2& position = course->getWallPositions()[i];
+        const CourseFormat::Vec2& size = course->getWallSizes()[i];
+        obstacle = std::make_unique<Obstacle>(sf::Vector2f(position.x, position.y),
+                                              sf::Vector2f(size.x, size.y),
+                                              sf::Color(course->getWallColors()[i]));
+        obstacle->setRotation(course->getWallRotations()[i]);
+    } else {
+        const WallSpec& wall = activeJob.walls[activeJob.nextWall];
+        obstacle = std::make_unique<Obstacle>(wall.position, wall.size, wall.color);
+        obstacle->setRotation(wall.rotation);
     }
     
-    // Check overlap with existing obstacles (simplified check)
-    // Instead of detailed rect intersection, just check center distance for performance
-    for (auto obstacle : obstacles) {
-        sf::FloatRect existingBounds = obstacle->getBounds();
-        sf::Vector2f existingCenter = {
-            existingBounds.position.x + existingBounds.size.x / 2.f,
-            existingBounds.position.y + existingBounds.size.y / 2.f
-        };
-        
-        float distToObstacle = std::hypot(pos.x - existingCenter.x, pos.y - existingCenter.y);
-        float minDist = (size.x + size.y + existingBounds.size.x + existingBounds.size.y) / 4.f;
-        
-        if (distToObstacle < minDist) {
-            return false;
+    obstacle->setChunk(activeJob.chunk);
+    entities.push_back(std::move(obstacle));
+    
+    // Chunk finished
+    if (++activeJob.nextWall >= activeJob.wallCount) {
+        activeJob = ChunkJob();
+    }
+}
+
+void ObstacleGenerator::evictChunks(int firstChunk, int lastChunk,
+                                    std::vector<std::unique_ptr<Entity>>& entities) {
+    auto outsideWindow = [&](int chunk) { return chunk < firstChunk || chunk > lastChunk; };
+    
+    // Abandon a chunk that is still being built
+    if (activeJob.chunk != NoChunk && outsideWindow(activeJob.chunk)) {
+        activeJob = ChunkJob();
+    }
+    
+    bool anyEvicted = false;
+    for (auto it = liveChunks.begin(); it != liveChunks.end();) {
+        if (outsideWindow(*it)) {
+            it = liveChunks.erase(it);
+            anyEvicted = true;
+        } else {
+            ++it;
         }
     }
+    if (!anyEvicted) return;
     
-    return true;
+    // Remove walls belonging to evicted chunks (obstacles without a chunk are left alone)
+    entities.erase(
+        std::remove_if(entities.begin(), entities.end(),
+            [&](const std::unique_ptr<Entity>& entity) {
+                auto obstacle = dynamic_cast<const Obstacle*>(entity.get());
+                return obstacle && obstacle->getChunk() >= 0 && outsideWindow(obstacle->getChunk());
+            }),
+        entities.end()
+    );
+}
+
+void ObstacleGenerator::saveState(State& state) const {
+    state.lastGenerationPos = lastGenerationPos;
+    state.requiredChunk = requiredChunk;
+    state.activeChunk = activeJob.chunk;
+    state.nextWall = activeJob.nextWall;
+    state.stats = stats;
+    state.liveChunks.assign(liveChunks.begin(), liveChunks.end());
+    state.pendingChunks.assign(pendingChunks.begin(), pendingChunks.end());
+}
+
+void ObstacleGenerator::restoreState(const State& state) {
+    liveChunks.clear();
+    liveChunks.insert(state.liveChunks.begin(), state.liveChunks.end());
+    pendingChunks.assign(state.pendingChunks.begin(), state.pendingChunks.end());
+    
+    // Rebuild the walls of the chunk in progress and skip the ones already spawned.
+    // Its layout was settled when it was first started, so nothing is validated.
+    activeJob = ChunkJob();
+    if (state.activeChunk != NoChunk) {
+        startChunk(state.activeChunk);
+        activeJob.nextWall = state.nextWall;
+    }
+    
+    lastGenerationPos = state.lastGenerationPos;
+    requiredChunk = state.requiredChunk;
+    stats = state.stats;
 }
 
 void ObstacleGenerator::updateLastGenerationPosition(const sf::Vector2f& position) {
@@ -215,8 +550,11 @@ void ObstacleGenerator::updateLastGenerationPosition(const sf::Vector2f& positio
 }
 
 bool ObstacleGenerator::shouldGenerateObstacles(const sf::Vector2f& currentPosition) const {
+    // Nothing built yet
+    if (liveChunks.empty()) return true;
+    
     // Generate obstacles if we've moved far enough from the last generation point
-    float distance = std::hypot(currentPosition.x - lastGenerationPos.x, 
+    float distance = std::hypot(currentPosition.x - lastGenerationPos.x,
                               currentPosition.y - lastGenerationPos.y);
     return distance > obstacleGenerationDistance;
-} 
\ No newline at end of file
+}
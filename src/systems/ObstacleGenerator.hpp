@@ -1,14 +1,23 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
-#include <random>
+#include <cstdint>
 #include <vector>
 #include <memory>
-#include <queue>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <set>
+#include <deque>
+#include "CourseValidator.hpp"
+#include "../utils/MemoryTracker.hpp"
 
 class Entity;
 class Ball;
 class Obstacle;
+class CourseFile;
+class FrameArena;
+class JobSystem;
 
 // Path segment structure
 struct PathSegment {
@@ -17,23 +26,110 @@ struct PathSegment {
     float width;
 };
 
-// ObstacleGenerator responsible for generating random path walls
+// Description of a single wall, independent of any live Obstacle
+struct WallSpec {
+    sf::Vector2f position;
+    sf::Vector2f size;
+    float rotation;    // Degrees
+    sf::Color color;
+};
+
+// Everything generated for one chunk of the course
+struct CourseChunk {
+    int index;
+    std::vector<PathSegment> segments;
+    std::vector<WallSpec> walls;
+};
+
+// Generation work done in the last frame and what is still queued
+struct GenerationStats {
+    std::size_t backlogChunks = 0;      // Chunks queued or in progress
+    std::size_t backlogWalls = 0;       // Walls left in the chunk in progress
+    int wallsThisFrame = 0;
+    float frameMicroseconds = 0.f;      // Time spent generating in the last frame
+    float maxFrameMicroseconds = 0.f;
+    std::uint64_t framesOverBudget = 0;
+    std::uint64_t rejectedLayouts = 0;  // Layouts that failed validation in the chunks built
+    std::uint64_t validationStalls = 0; // Needed by the ball before their validation finished
+};
+
+// ObstacleGenerator responsible for generating random path walls.
+// The course is split into chunks along the x axis; each chunk's layouts are
+// drawn from (world seed, chunk index), so chunks can be built in any order,
+// discarded once the ball has left them and rebuilt on demand.
+// Building is incremental: chunks are queued, then created a wall at a time
+// within a per-frame time budget. As soon as a chunk is queued its layout is
+// validated with simulated shots on the job system; a layout that fails is
+// replaced by another variant drawn from the same seed, and as a last resort
+// by a straight path. Chunks are built once their verdict is in; a chunk the
+// ball needs before then holds up generation until it has one, so the layout
+// never depends on thread timing. Layouts are kept, so rebuilds always match.
 class ObstacleGenerator {
 public:
+    static constexpr int NoChunk = -1;     // No chunk (nothing in progress)
+    
+    // Bookkeeping containers, counted as generation memory
+    using ChunkSet = std::set<int, std::less<int>, Memory::TaggedAllocator<int, Memory::Tag::Generation>>;
+    using ChunkQueue = std::deque<int, Memory::TaggedAllocator<int, Memory::Tag::Generation>>;
+    using WallList = Memory::TaggedVector<WallSpec, Memory::Tag::Generation>;
+    
+    // Layout variants tried before falling back to the straight one
+    static const int MaxLayoutVariants = 4;
+    
     ObstacleGenerator();
-    ~ObstacleGenerator() = default;
+    explicit ObstacleGenerator(std::uint64_t seed);
+    
+    // Waits for the validation jobs still running
+    ~ObstacleGenerator();
+    
+    // Queue the missing chunks around the ball, start validating them and evict
+    // the ones the ball has left behind
+    void scheduleChunks(const sf::Vector2f& ballPosition,
+                        std::vector<std::unique_ptr<Entity>>& entities);
+    
+    // Do queued generation work for at most budgetMicroseconds. Chunks are taken
+    // in queue order once validated. Chunks up to the one after the ball's are
+    // always finished, whatever the budget, waiting for their validation if needed.
+    void generateObstacles(std::vector<std::unique_ptr<Entity>>& entities, float budgetMicroseconds);
+    
+    bool hasPendingWork() const { return activeJob.chunk != NoChunk || !pendingChunks.empty(); }
+    const GenerationStats& getStats() const { return stats; }
+    
+    // Remove the walls of every live chunk
+    void clearChunks(std::vector<std::unique_ptr<Entity>>& entities);
+    
+    // Build the segments and walls of a chunk with the layout it is built with in the
+    // game. If the chunk has no layout yet it is validated first, on the calling
+    // thread with help from the job system if one is set. Safe to call from any thread.
+    CourseChunk generateChunk(int chunkIndex) const;
+    
+    // Chunk as it appears in the course: taken from the loaded course file if it
+    // contains the chunk, generated from the seed otherwise
+    CourseChunk chunkAt(int chunkIndex) const;
+    
+    // Serve chunks from a mapped course file (nullptr to go back to pure generation).
+    // The file must outlive the generator or be reset before it is destroyed.
+    void setCourse(const CourseFile* courseFile) { course = courseFile; }
+    
+    // Take per-chunk scratch memory from a frame arena (nullptr to use the heap)
+    void setFrameArena(FrameArena* arena) { frameArena = arena; }
+    
+    // Threads to validate queued chunks on in the background, which also play the runs
+    // of chunks validated on the calling thread (nullptr to do everything on the calling thread)
+    void setJobSystem(JobSystem* jobs);
     
-    // Generate obstacles based on ball position to form a path
-    void generateObstacles(const sf::Vector2f& ballPosition, 
-                          std::vector<std::unique_ptr<Entity>>& entities,
-                          const std::vector<Obstacle*>& existingObstacles);
+    // What a chunk's walls are built from: its layout variant, CourseFileLayout, or
+    // NoLayout if it has none yet. Two builds of a chunk with the same layout
+    // have the same walls.
+    static constexpr int CourseFileLayout = -1;
+    static constexpr int NoLayout = -2;
+    int getBuiltLayout(int chunkIndex) const;
     
-    // Check if a position is valid for a new obstacle
-    bool isValidObstaclePosition(const sf::Vector2f& pos, 
-                                const sf::Vector2f& size, 
-                                const sf::Vector2f& ballPosition,
-                                float ballRadius,
-                                const std::vector<Obstacle*>& obstacles);
+    // Validation result of the layout a chunk is built with
+    ChunkVerdict getChunkVerdict(int chunkIndex) const { return chunkLayout(chunkIndex).verdict; }
+    
+    // Chunk containing a world position
+    int chunkIndexAt(const sf::Vector2f& position) const;
     
     // Track the last generation position to avoid generating too frequently
     void updateLastGenerationPosition(const sf::Vector2f& position);
@@ -41,30 +137,122 @@ public:
     // Check if new obstacles should be generated based on distance moved
     bool shouldGenerateObstacles(const sf::Vector2f& currentPosition) const;
     
+    std::uint64_t getSeed() const { return seed; }
+    
+    // Chunk bookkeeping and progress, for snapshots. Walls are a pure function of the
+    // seed, so the chunk in progress is saved as its index and the next wall to build.
+    struct State {
+        sf::Vector2f lastGenerationPos;
+        int requiredChunk = 0;
+        int activeChunk = NoChunk;
+        std::uint32_t nextWall = 0;
+        GenerationStats stats;
+        Memory::TaggedVector<int, Memory::Tag::Snapshots> liveChunks;
+        Memory::TaggedVector<int, Memory::Tag::Snapshots> pendingChunks;
+    };
+    
+    // Copy the state into state; its buffers are reused, so saving into the same state again doesn't allocate
+    void saveState(State& state) const;
+    void restoreState(const State& state);
+    const ChunkSet& getLiveChunks() const { return liveChunks; }
+
 private:
-    // Generate a new path segment ahead of the ball
-    std::vector<PathSegment> generatePathSegments(const sf::Vector2f& ballPosition);
+    // Position and width of the path at a chunk boundary, shared by both neighbours
+    sf::Vector2f boundaryPoint(int boundaryIndex) const;
+    float boundaryWidth(int boundaryIndex) const;
+    
+    // Layout variant a chunk is built with, and its verdict
+    static const int StraightLayout = MaxLayoutVariants;
+    struct ChunkLayout {
+        int variant;
+        ChunkVerdict verdict;
+    };
+    using LayoutMap = std::map<int, ChunkLayout, std::less<int>,
+                               Memory::TaggedAllocator<std::pair<const int, ChunkLayout>, Memory::Tag::Generation>>;
+    
+    // Layout a chunk is built with: the cached one, or the first variant that passes validation
+    ChunkLayout chunkLayout(int chunkIndex) const;
+    
+    // Validate the layout variants of a chunk with a validator until one passes (no caching)
+    ChunkLayout validateLayout(int chunkIndex, const CourseValidator& validator) const;
+    
+    // Validate a queued chunk on the job system unless it is read from the course file,
+    // validated already or being validated
+    void requestValidation(int chunkIndex);
+    
+    // True when a chunk can be built without waiting: its walls come from the course
+    // file or its layout is known
+    bool isChunkReady(int chunkIndex) const;
+    
+    // Layout to build a chunk with: the cached one, after waiting for its validation
+    // job if one is running, or validated on this thread
+    ChunkLayout settleLayout(int chunkIndex);
     
-    // Create wall obstacles from path segments
-    void createWallsFromPath(const std::vector<PathSegment>& segments, 
-                             std::vector<std::unique_ptr<Entity>>& entities,
-                             const sf::Vector2f& ballPosition,
-                             const std::vector<Obstacle*>& existingObstacles);
+    // Segments and walls of one layout variant of a chunk
+    CourseChunk buildChunk(int chunkIndex, int variant) const;
     
-    std::mt19937 rng;
+    // Write the segmentsPerChunk path segments of a layout variant to segments.
+    // Variant 0 is the original layout, StraightLayout puts the nodes on the chord.
+    void generatePathSegments(int chunkIndex, int variant, PathSegment* segments) const;
+    
+    // Write the two walls of each path segment to walls
+    void createWallsFromPath(int chunkIndex, const PathSegment* segments, std::size_t segmentCount,
+                             WallSpec* walls) const;
+    
+    // Begin building a chunk: read it from the course file or generate its walls (never validates)
+    void startChunk(int chunkIndex);
+    
+    // Add the next wall of the chunk in progress to the entity list
+    void spawnNextWall(std::vector<std::unique_ptr<Entity>>& entities);
+    
+    // Remove the walls of every live chunk outside [firstChunk, lastChunk]
+    void evictChunks(int firstChunk, int lastChunk, std::vector<std::unique_ptr<Entity>>& entities);
+    
+    std::uint64_t seed;
+    const CourseFile* course;          // Optional fixed course, not owned
+    FrameArena* frameArena;            // Optional scratch memory, not owned
     sf::Vector2f lastGenerationPos;
+    ChunkSet liveChunks;               // Chunks whose walls currently exist (fully or partly)
     
-    // Path state
-    std::queue<PathSegment> pathQueue; // Store future path segments
-    sf::Vector2f currentPathEnd;       // End point of the last generated path
-    sf::Vector2f currentPathDirection; // Current direction of the path
-    float currentPathWidth;            // Current width of the path
+    // Incremental generation state
+    struct ChunkJob {
+        int chunk = NoChunk;
+        std::uint32_t nextWall = 0;
+        std::uint32_t wallCount = 0;
+        bool fromFile = false;             // Walls come from the mapped course arrays...
+        std::uint32_t firstWall = 0;       // ...starting at this index
+        WallList walls;                    // Generated walls otherwise
+    };
+    ChunkJob activeJob;
+    ChunkQueue pendingChunks;          // Nearest to the ball first
+    int requiredChunk;                 // Chunks up to this one are built regardless of budget
+    GenerationStats stats;
+    
+    // Chunk validation
+    CourseValidator validator;         // Spreads its runs over the job system, for callers that wait
+    CourseValidator jobValidator;      // Plays its runs inside the background job validating the chunk
+    JobSystem* jobSystem;              // Optional, not owned
+    mutable std::mutex layoutMutex;
+    std::condition_variable validationDone;
+    mutable LayoutMap layouts;         // Guarded by layoutMutex
+    ChunkSet queuedValidations;        // Submitted but not started, guarded by layoutMutex
+    ChunkSet runningValidations;       // Being validated by a job, guarded by layoutMutex
+    std::size_t validationJobs;        // Jobs that haven't returned yet, guarded by layoutMutex
+    
+    // Path layout
+    sf::Vector2f courseOrigin;         // Start of chunk 0
+    int segmentsPerChunk;
+    float segmentSpacing;              // Average horizontal length of a segment
     
     // Configuration parameters
     float obstacleGenerationDistance;
-    float minObstacleDistance;
-    int maxObstacleCount;
+    int chunksAhead;
+    int chunksBehind;
+    
+    // Bound on the whole course's heading, not a per-segment turn limit: every
+    // segment stays within half this angle of +x, so the course always runs
+    // left to right and two consecutive segments turn by at most this angle
     float maxPathTurnAngle;
     float minPathSegmentLength;
     float maxPathSegmentLength;
-}; 
\ No newline at end of file
+};
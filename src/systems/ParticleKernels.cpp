@@ -0,0 +1,175 @@
+#include "ParticleKernels.hpp"
+#include <atomic>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MINI_GOLF_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang need the instruction set enabled per function; MSVC accepts the intrinsics anywhere
+#if defined(MINI_GOLF_X86) && (defined(__GNUC__) || defined(__clang__))
+#define MINI_GOLF_TARGET(isa) __attribute__((target(isa)))
+#else
+#define MINI_GOLF_TARGET(isa)
+#endif
+
+namespace {
+    // Same constants as Particle::update
+    const float Gravity = 50.f;
+    const float Drag = 0.98f;
+    
+    bool detectAVX2() {
+#if defined(MINI_GOLF_X86) && (defined(__GNUC__) || defined(__clang__))
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#elif defined(MINI_GOLF_X86) && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        
+        // The CPU must support AVX and the OS must save the YMM registers
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+        
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return false;
+#endif
+    }
+    
+    ParticleKernels::Backend detectBestBackend() {
+        if (ParticleKernels::isSupported(ParticleKernels::Backend::AVX2)) return ParticleKernels::Backend::AVX2;
+        if (ParticleKernels::isSupported(ParticleKernels::Backend::SSE2)) return ParticleKernels::Backend::SSE2;
+        return ParticleKernels::Backend::Scalar;
+    }
+    
+    std::atomic<int> selectedBackend{-1};
+}
+
+namespace ParticleKernels {
+
+void integrateScalar(const ParticleArrays& p, std::size_t begin, std::size_t end, float deltaTime) {
+    float gravityStep = Gravity * deltaTime;
+    for (std::size_t i = begin; i < end; ++i) {
+        p.lifetime[i] -= deltaTime;
+        p.positionX[i] += p.velocityX[i] * deltaTime;
+        p.positionY[i] += p.velocityY[i] * deltaTime;
+        p.velocityX[i] = p.velocityX[i] * Drag;
+        p.velocityY[i] = (p.velocityY[i] + gravityStep) * Drag;
+    }
+}
+
+#ifdef MINI_GOLF_X86
+
+MINI_GOLF_TARGET("sse2")
+void integrateSSE2(const ParticleArrays& p, std::size_t begin, std::size_t end, float deltaTime) {
+    const __m128 dt = _mm_set1_ps(deltaTime);
+    const __m128 gravityStep = _mm_set1_ps(Gravity * deltaTime);
+    const __m128 drag = _mm_set1_ps(Drag);
+    
+    std::size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m128 vx = _mm_loadu_ps(p.velocityX + i);
+        __m128 vy = _mm_loadu_ps(p.velocityY + i);
+        
+        _mm_storeu_ps(p.lifetime + i, _mm_sub_ps(_mm_loadu_ps(p.lifetime + i), dt));
+        _mm_storeu_ps(p.positionX + i, _mm_add_ps(_mm_loadu_ps(p.positionX + i), _mm_mul_ps(vx, dt)));
+        _mm_storeu_ps(p.positionY + i, _mm_add_ps(_mm_loadu_ps(p.positionY + i), _mm_mul_ps(vy, dt)));
+        _mm_storeu_ps(p.velocityX + i, _mm_mul_ps(vx, drag));
+        _mm_storeu_ps(p.velocityY + i, _mm_mul_ps(_mm_add_ps(vy, gravityStep), drag));
+    }
+    
+    // Remaining particles
+    integrateScalar(p, i, end, deltaTime);
+}
+
+MINI_GOLF_TARGET("avx2")
+void integrateAVX2(const ParticleArrays& p, std::size_t begin, std::size_t end, float deltaTime) {
+    const __m256 dt = _mm256_set1_ps(deltaTime);
+    const __m256 gravityStep = _mm256_set1_ps(Gravity * deltaTime);
+    const __m256 drag = _mm256_set1_ps(Drag);
+    
+    std::size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256 vx = _mm256_loadu_ps(p.velocityX + i);
+        __m256 vy = _mm256_loadu_ps(p.velocityY + i);
+        
+        _mm256_storeu_ps(p.lifetime + i, _mm256_sub_ps(_mm256_loadu_ps(p.lifetime + i), dt));
+        _mm256_storeu_ps(p.positionX + i, _mm256_add_ps(_mm256_loadu_ps(p.positionX + i), _mm256_mul_ps(vx, dt)));
+        _mm256_storeu_ps(p.positionY + i, _mm256_add_ps(_mm256_loadu_ps(p.positionY + i), _mm256_mul_ps(vy, dt)));
+        _mm256_storeu_ps(p.velocityX + i, _mm256_mul_ps(vx, drag));
+        _mm256_storeu_ps(p.velocityY + i, _mm256_mul_ps(_mm256_add_ps(vy, gravityStep), drag));
+    }
+    
+    // Remaining particles
+    integrateSSE2(p, i, end, deltaTime);
+}
+
+#else
+
+// No x86 SIMD on this platform; isSupported() never reports these backends
+void integrateSSE2(const ParticleArrays& p, std::size_t begin, std::size_t end, float deltaTime) {
+    integrateScalar(p, begin, end, deltaTime);
+}
+
+void integrateAVX2(const ParticleArrays& p, std::size_t begin, std::size_t end, float deltaTime) {
+    integrateScalar(p, begin, end, deltaTime);
+}
+
+#endif
+
+void integrate(const ParticleArrays& particles, std::size_t begin, std::size_t end, float deltaTime) {
+    switch (getBackend()) {
+        case Backend::AVX2: integrateAVX2(particles, begin, end, deltaTime); break;
+        case Backend::SSE2: integrateSSE2(particles, begin, end, deltaTime); break;
+        default: integrateScalar(particles, begin, end, deltaTime); break;
+    }
+}
+
+bool isSupported(Backend backend) {
+    switch (backend) {
+        case Backend::Scalar:
+            return true;
+        case Backend::SSE2:
+#ifdef MINI_GOLF_X86
+            return true;    // Every x86 CPU we run on has SSE2
+#else
+            return false;
+#endif
+        case Backend::AVX2: {
+            static const bool hasAVX2 = detectAVX2();
+            return hasAVX2;
+        }
+    }
+    return false;
+}
+
+Backend getBackend() {
+    int backend = selectedBackend.load(std::memory_order_relaxed);
+    if (backend < 0) {
+        backend = static_cast<int>(detectBestBackend());
+        selectedBackend.store(backend, std::memory_order_relaxed);
+    }
+    return static_cast<Backend>(backend);
+}
+
+void setBackend(Backend backend) {
+    if (!isSupported(backend)) backend = Backend::Scalar;
+    selectedBackend.store(static_cast<int>(backend), std::memory_order_relaxed);
+}
+
+const char* getBackendName(Backend backend) {
+    switch (backend) {
+        case Backend::SSE2: return "SSE2";
+        case Backend::AVX2: return "AVX2";
+        default: return "Scalar";
+    }
+}
+
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+
+// Integration kernels for particles stored as structure-of-arrays.
+// Each kernel applies the same step as Particle::update: lifetime decrement,
+// position integration, gravity and drag. Fade and shrink are derived from
+// the remaining lifetime when particles are drawn.
+namespace ParticleKernels {
+    enum class Backend {
+        Scalar,
+        SSE2,    // 4 particles per instruction
+        AVX2     // 8 particles per instruction
+    };
+    
+    // Pointers to the particle arrays the kernels work on
+    struct ParticleArrays {
+        float* positionX;
+        float* positionY;
+        float* velocityX;
+        float* velocityY;
+        float* lifetime;
+    };
+    
+    // Integrate particles [begin, end) with the active backend
+    void integrate(const ParticleArrays& particles, std::size_t begin, std::size_t end, float deltaTime);
+    
+    // Individual backends (only call the SIMD ones when isSupported() says so)
+    void integrateScalar(const ParticleArrays& particles, std::size_t begin, std::size_t end, float deltaTime);
+    void integrateSSE2(const ParticleArrays& particles, std::size_t begin, std::size_t end, float deltaTime);
+    void integrateAVX2(const ParticleArrays& particles, std::size_t begin, std::size_t end, float deltaTime);
+    
+    // Backend selection: the best supported one is picked on first use
+    bool isSupported(Backend backend);
+    Backend getBackend();
+    void setBackend(Backend backend);    // Falls back to Scalar if unsupported
+    const char* getBackendName(Backend backend);
+}
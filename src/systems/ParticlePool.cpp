@@ -0,0 +1,126 @@
+#include "ParticlePool.hpp"
+#include <algorithm>
+#include <cstring>
+
+ParticlePool::ParticlePool(std::size_t capacity)
+    : positionX(capacity)
+    , positionY(capacity)
+    , velocityX(capacity)
+    , velocityY(capacity)
+    , lifetime(capacity)
+    , initialLifetime(capacity)
+    , radius(capacity)
+    , color(capacity)
+    , maxParticles(capacity)
+    , count(0)
+    , highWater(0)
+    , dropped(0)
+{
+}
+
+namespace {
+    template <typename Array>
+    std::uint8_t* copyOut(const Array& array, std::size_t count, std::uint8_t* buffer) {
+        std::size_t bytes = count * sizeof(array[0]);
+        std::memcpy(buffer, array.data(), bytes);
+        return buffer + bytes;
+    }
+    
+    template <typename Array>
+    const std::uint8_t* copyIn(Array& array, std::size_t count, const std::uint8_t* buffer) {
+        std::size_t bytes = count * sizeof(array[0]);
+        std::memcpy(array.data(), buffer, bytes);
+        return buffer + bytes;
+    }
+}
+
+bool ParticlePool::spawn(const sf::Vector2f& position, const sf::Vector2f& velocity,
+                         float particleLifetime, float size, const sf::Color& particleColor) {
+    if (count == maxParticles) {
+        dropped++;
+        return false;
+    }
+    
+    std::size_t i = count++;
+    positionX[i] = position.x;
+    positionY[i] = position.y;
+    velocityX[i] = velocity.x;
+    velocityY[i] = velocity.y;
+    lifetime[i] = particleLifetime;
+    initialLifetime[i] = particleLifetime;
+    radius[i] = size;
+    color[i] = particleColor;
+    
+    highWater = std::max(highWater, count);
+    return true;
+}
+
+void ParticlePool::kill(std::size_t i) {
+    std::size_t last = --count;
+    
+    // Fill the hole with the last particle
+    if (i != last) {
+        move(last, i);
+    }
+}
+
+std::size_t ParticlePool::compactRange(std::size_t begin, std::size_t end) {
+    std::size_t alive = begin;
+    for (std::size_t i = begin; i < end; ++i) {
+        if (lifetime[i] > 0.f) {
+            if (i != alive) move(i, alive);
+            alive++;
+        }
+    }
+    return alive - begin;
+}
+
+void ParticlePool::gatherRanges(const std::size_t* aliveCounts, std::size_t rangeCount, std::size_t rangeSize) {
+    std::size_t total = 0;
+    for (std::size_t range = 0; range < rangeCount; ++range) {
+        std::size_t start = range * rangeSize;
+        
+        // Ranges only ever move down, so this never overwrites live data
+        if (start != total) {
+            for (std::size_t i = 0; i < aliveCounts[range]; ++i) {
+                move(start + i, total + i);
+            }
+        }
+        total += aliveCounts[range];
+    }
+    count = total;
+}
+
+void ParticlePool::move(std::size_t from, std::size_t to) {
+    positionX[to] = positionX[from];
+    positionY[to] = positionY[from];
+    velocityX[to] = velocityX[from];
+    velocityY[to] = velocityY[from];
+    lifetime[to] = lifetime[from];
+    initialLifetime[to] = initialLifetime[from];
+    radius[to] = radius[from];
+    color[to] = color[from];
+}
+
+void ParticlePool::saveState(std::uint8_t* buffer) const {
+    buffer = copyOut(positionX, count, buffer);
+    buffer = copyOut(positionY, count, buffer);
+    buffer = copyOut(velocityX, count, buffer);
+    buffer = copyOut(velocityY, count, buffer);
+    buffer = copyOut(lifetime, count, buffer);
+    buffer = copyOut(initialLifetime, count, buffer);
+    buffer = copyOut(radius, count, buffer);
+    copyOut(color, count, buffer);
+}
+
+void ParticlePool::restoreState(const std::uint8_t* buffer, std::size_t particleCount) {
+    count = std::min(particleCount, maxParticles);
+    buffer = copyIn(positionX, count, buffer);
+    buffer = copyIn(positionY, count, buffer);
+    buffer = copyIn(velocityX, count, buffer);
+    buffer = copyIn(velocityY, count, buffer);
+    buffer = copyIn(lifetime, count, buffer);
+    buffer = copyIn(initialLifetime, count, buffer);
+    buffer = copyIn(radius, count, buffer);
+    copyIn(color, count, buffer);
+}
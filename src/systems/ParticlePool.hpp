@@ -0,0 +1,80 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ParticleKernels.hpp"
+#include "../utils/MemoryTracker.hpp"
+
+// Fixed-capacity particle storage laid out as structure-of-arrays.
+// Every array is allocated once in the constructor, so spawning, updating
+// and removing particles never touch the heap. Live particles always occupy
+// the first size() slots; removal moves the last particle into the hole.
+class ParticlePool {
+public:
+    explicit ParticlePool(std::size_t capacity);
+    
+    // Add a particle; when the pool is full the particle is dropped and counted
+    bool spawn(const sf::Vector2f& position, const sf::Vector2f& velocity,
+               float lifetime, float size, const sf::Color& color);
+    
+    // Remove particle i (swap-with-last, so the order of particles changes)
+    void kill(std::size_t i);
+    
+    // Move the live particles of [begin, end) to the front of that range,
+    // keeping their order; returns how many are alive. Disjoint ranges can be
+    // compacted from different threads at the same time.
+    std::size_t compactRange(std::size_t begin, std::size_t end);
+    
+    // Join ranges compacted by compactRange: range i starts at i * rangeSize
+    // and holds aliveCounts[i] live particles
+    void gatherRanges(const std::size_t* aliveCounts, std::size_t rangeCount, std::size_t rangeSize);
+    
+    void clear() { count = 0; }
+    
+    std::size_t size() const { return count; }
+    std::size_t capacity() const { return maxParticles; }
+    bool empty() const { return count == 0; }
+    
+    // Largest number of live particles seen, and particles dropped because the pool was full
+    std::size_t highWaterMark() const { return highWater; }
+    std::size_t droppedCount() const { return dropped; }
+    void resetHighWaterMark() { highWater = count; dropped = 0; }
+    
+    // Bytes of one particle across all arrays
+    static constexpr std::size_t BytesPerParticle = 7 * sizeof(float) + sizeof(sf::Color);
+    
+    // Copy the live particles, array after array, to buffer (size() * BytesPerParticle bytes)
+    void saveState(std::uint8_t* buffer) const;
+    
+    // Replace the live particles with particleCount ones written by saveState
+    void restoreState(const std::uint8_t* buffer, std::size_t particleCount);
+    
+    // Arrays the integration kernels work on
+    ParticleKernels::ParticleArrays kernelArrays() {
+        return {positionX.data(), positionY.data(), velocityX.data(), velocityY.data(), lifetime.data()};
+    }
+    
+    // Particle data, valid for indices [0, size())
+    template <typename T>
+    using Array = Memory::TaggedVector<T, Memory::Tag::Particles>;
+    
+    Array<float> positionX;
+    Array<float> positionY;
+    Array<float> velocityX;
+    Array<float> velocityY;
+    Array<float> lifetime;               // Remaining lifetime in seconds
+    Array<float> initialLifetime;
+    Array<float> radius;
+    Array<sf::Color> color;
+
+private:
+    // Copy particle from into slot to
+    void move(std::size_t from, std::size_t to);
+    
+    std::size_t maxParticles;
+    std::size_t count;
+    std::size_t highWater;
+    std::size_t dropped;
+};
@@ -1,79 +1,61 @@
 #include "ParticleSystem.hpp"
+#include "../core/JobSystem.hpp"
 #include <chrono>
 #include <cmath>
+#include <algorithm>
+#include <limits>
 
-ParticleSystem::ParticleSystem() {
-    // Initialize random number generator with time-based seed
-    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-    rng.seed(seed);
+const ParticleSystem::EmitterSettings ParticleSystem::CollisionEmitter = {
+    50.f, 150.f,                            // Speed
+    0.3f, 0.7f,                             // Lifetime
+    1.5f, 3.5f,                             // Size
+    60.f, 0.f,                              // Spread, jitter
+    sf::Color::White, sf::Color::White
+};
+
+const ParticleSystem::EmitterSettings ParticleSystem::MovementEmitter = {
+    20.f, 80.f,
+    0.4f, 0.8f,
+    2.f, 4.f,
+    90.f, 0.f,
+    sf::Color(0, 150, 0), sf::Color(0, 255, 0)
+};
+
+const ParticleSystem::EmitterSettings ParticleSystem::TrailEmitter = {
+    10.f, 30.f,
+    0.2f, 0.5f,
+    1.5f, 3.f,
+    30.f, 5.f,
+    sf::Color(0, 150, 0, 200), sf::Color(0, 255, 0, 200)    // Slightly transparent
+};
+
+ParticleSystem::ParticleSystem(std::size_t capacity)
+    : pool(capacity)
+    , jobSystem(nullptr)
+    , parallelBlockSize(std::clamp(capacity / 4, MinParallelBlockSize, MaxParallelBlockSize))
+    , blockAliveCounts(capacity / parallelBlockSize + 1)
+    , vertices(capacity * MaxVerticesPerParticle)
+    , quality{1.f, 1.f, MaxParticleSides, std::numeric_limits<std::size_t>::max()}
+    , emissionBudget(quality.maxEmittedPerFrame)
+    , rng(std::chrono::system_clock::now().time_since_epoch().count())
+{
+    buildPolygon(quality.sides);
+    
+    // Build the preset cones up front so emitting never allocates
+    coneTables.reserve(8);
+    getConeTable(CollisionEmitter.spread);
+    getConeTable(MovementEmitter.spread);
+    getConeTable(TrailEmitter.spread);
 }
 
 void ParticleSystem::createCollisionParticles(const sf::Vector2f& position, const sf::Vector2f& normal) {
-    // Create 8-12 particles at the collision point
-    std::uniform_int_distribution<int> countDist(8, 12);
-    int particleCount = countDist(rng);
-    
-    // Random distributions for particle properties
-    std::uniform_real_distribution<float> speedDist(50.f, 150.f);
-    std::uniform_real_distribution<float> lifetimeDist(0.3f, 0.7f);
-    std::uniform_real_distribution<float> sizeDist(1.5f, 3.5f);
-    
-    // Reflect normal slightly to spread particles in the bounce direction
-    sf::Vector2f baseDirection = normal;
-    
-    for (int i = 0; i < particleCount; ++i) {
-        // Generate random properties
-        float speed = speedDist(rng);
-        float lifetime = lifetimeDist(rng);
-        float size = sizeDist(rng);
-        
-        // Generate a direction within a cone 
-        sf::Vector2f direction = randomDirectionInCone(baseDirection, 60.f); // 60 degree spread
-        sf::Vector2f velocity = direction * speed;
-        
-        // Create and add the particle
-        auto particle = std::make_unique<Particle>(position, velocity, lifetime, size);
-        particle->setColor(sf::Color::White);
-        particles.push_back(std::move(particle));
-    }
+    // Create 8-12 particles at the collision point, spread in the bounce direction
+    emitBurst(CollisionEmitter, position, normal, rng.uniformInt(8, 12));
 }
 
 void ParticleSystem::createMovementParticles(const sf::Vector2f& position, const sf::Vector2f& direction) {
-    // Create 15-20 green particles at the ball's position
-    std::uniform_int_distribution<int> countDist(15, 20);
-    int particleCount = countDist(rng);
-    
-    // Random distributions for particle properties
-    std::uniform_real_distribution<float> speedDist(20.f, 80.f);
-    std::uniform_real_distribution<float> lifetimeDist(0.4f, 0.8f);
-    std::uniform_real_distribution<float> sizeDist(2.f, 4.f);
-    
-    // Create particles in the opposite direction of movement (trailing effect)
-    sf::Vector2f baseDirection = -direction; // Opposite direction to create a trail
-    
-    // Create green particles with different shades
-    std::uniform_int_distribution<int> greenShadeDist(150, 255);
-    
-    for (int i = 0; i < particleCount; ++i) {
-        // Generate random properties
-        float speed = speedDist(rng);
-        float lifetime = lifetimeDist(rng);
-        float size = sizeDist(rng);
-        
-        // Generate a direction within a wider cone for more spread
-        sf::Vector2f particleDir = randomDirectionInCone(baseDirection, 90.f); // 90 degree spread
-        sf::Vector2f velocity = particleDir * speed;
-        
-        // Create and add the particle with a random shade of green
-        auto particle = std::make_unique<Particle>(position, velocity, lifetime, size);
-        
-        // Create a random shade of green
-        int greenShade = greenShadeDist(rng);
-        sf::Color greenColor(0, greenShade, 0);
-        particle->setColor(greenColor);
-        
-        particles.push_back(std::move(particle));
-    }
+    // Create 15-20 green particles opposite to the direction of movement
+    emitBurst(MovementEmitter, position, -direction, rng.uniformInt(15, 20));
 }
 
 void ParticleSystem::createTrailParticles(const sf::Vector2f& position, const sf::Vector2f& direction, float speed) {
@@ -81,84 +63,182 @@ void ParticleSystem::createTrailParticles(const sf::Vector2f& position, const sf
     int particleCount = 2 + static_cast<int>(speed / 50.0f); // More particles for faster speed
     particleCount = std::min(particleCount, 5); // Cap at 5 particles per update
     
-    // Random distributions for particle properties
-    std::uniform_real_distribution<float> offsetDist(-5.f, 5.f);
-    std::uniform_real_distribution<float> speedDist(10.f, 30.f);
-    std::uniform_real_distribution<float> lifetimeDist(0.2f, 0.5f);
-    std::uniform_real_distribution<float> sizeDist(1.5f, 3.f);
-    
-    // Create particles in the opposite direction of movement (trailing effect)
-    sf::Vector2f baseDirection = -direction; // Opposite direction to create a trail
-    
-    // Create green particles with different shades
-    std::uniform_int_distribution<int> greenShadeDist(150, 255);
+    emitBurst(TrailEmitter, position, -direction, particleCount);
+}
+
+void ParticleSystem::emitBurst(const EmitterSettings& settings, const sf::Vector2f& position,
+                               const sf::Vector2f& direction, int count) {
+    // Normalise the base direction once for the whole burst
+    float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+    sf::Vector2f base = length > 0 ? direction / length : sf::Vector2f(0, -1);
+    
+    const ConeTable& cone = getConeTable(settings.spread);
+    float speedRange = settings.maxSpeed - settings.minSpeed;
+    float minLifetime = settings.minLifetime * quality.lifetimeScale;
+    float lifetimeRange = (settings.maxLifetime - settings.minLifetime) * quality.lifetimeScale;
+    float sizeRange = settings.maxSize - settings.minSize;
+    float jitterRange = settings.positionJitter * 2.f;
+    
+    std::uint32_t randoms[EmitBatchSize * RandomsPerParticle];
+    // Scale the burst and clamp it to what's left of this update's emission budget
+    std::size_t remaining = 0;
+    if (count > 0) {
+        remaining = static_cast<std::size_t>(count * quality.emissionScale + 0.5f);
+        remaining = std::min(remaining, emissionBudget);
+        emissionBudget -= remaining;
+    }
     
-    for (int i = 0; i < particleCount; ++i) {
-        // Generate random properties
-        float particleSpeed = speedDist(rng);
-        float lifetime = lifetimeDist(rng);
-        float size = sizeDist(rng);
-        
-        // Add a slight random offset to the position to create a wider trail
-        sf::Vector2f offset(offsetDist(rng), offsetDist(rng));
-        sf::Vector2f particlePos = position + offset;
-        
-        // Generate a direction with a narrow cone for more focused trail
-        sf::Vector2f particleDir = randomDirectionInCone(baseDirection, 30.f); // 30 degree spread
-        sf::Vector2f velocity = particleDir * particleSpeed;
+    while (remaining > 0) {
+        std::size_t batch = std::min(remaining, EmitBatchSize);
+        rng.fill(randoms, batch * RandomsPerParticle);
+        remaining -= batch;
         
-        // Create and add the particle with a random shade of green
-        auto particle = std::make_unique<Particle>(particlePos, velocity, lifetime, size);
-        
-        // Create a random shade of green
-        int greenShade = greenShadeDist(rng);
-        sf::Color greenColor(0, greenShade, 0, 200); // Slightly transparent
-        particle->setColor(greenColor);
-        
-        particles.push_back(std::move(particle));
+        const std::uint32_t* r = randoms;
+        for (std::size_t i = 0; i < batch; ++i, r += RandomsPerParticle) {
+            // Each draw is split into 16-bit (or 8-bit) fields, plenty for visual effects
+            float speed = settings.minSpeed + speedRange * FastRng::toUnitFloat16(r[0]);
+            float lifetime = minLifetime + lifetimeRange * FastRng::toUnitFloat16(r[0] >> 16);
+            float size = settings.minSize + sizeRange * FastRng::toUnitFloat16(r[1]);
+            
+            // Rotate the base direction by a precomputed cone angle
+            const sf::Vector2f& rotation = cone.rotations[(r[1] >> 16) & 0xFF];
+            sf::Vector2f velocity(base.x * rotation.x - base.y * rotation.y,
+                                  base.x * rotation.y + base.y * rotation.x);
+            
+            float weight = static_cast<float>(r[1] >> 24) * (1.f / 255.f);
+            sf::Color color(
+                static_cast<std::uint8_t>(settings.minColor.r + (settings.maxColor.r - settings.minColor.r) * weight),
+                static_cast<std::uint8_t>(settings.minColor.g + (settings.maxColor.g - settings.minColor.g) * weight),
+                static_cast<std::uint8_t>(settings.minColor.b + (settings.maxColor.b - settings.minColor.b) * weight),
+                static_cast<std::uint8_t>(settings.minColor.a + (settings.maxColor.a - settings.minColor.a) * weight));
+            
+            sf::Vector2f offset(FastRng::toUnitFloat16(r[2]) * jitterRange - settings.positionJitter,
+                                FastRng::toUnitFloat16(r[2] >> 16) * jitterRange - settings.positionJitter);
+            
+            pool.spawn(position + offset, velocity * speed, lifetime, size, color);
+        }
     }
 }
 
-void ParticleSystem::update(float deltaTime) {
-    // Update all particles
-    for (auto& particle : particles) {
-        particle->update(deltaTime);
+const ParticleSystem::ConeTable& ParticleSystem::getConeTable(float spread) {
+    for (const auto& table : coneTables) {
+        if (table.spread == spread) return table;
     }
     
-    // Remove dead particles
-    particles.erase(
-        std::remove_if(particles.begin(), particles.end(),
-            [](const std::unique_ptr<Particle>& p) { return !p->isAlive(); }),
-        particles.end()
-    );
+    // Sample the middle of each step so the cone is symmetric
+    ConeTable table;
+    table.spread = spread;
+    float spreadRadians = spread * 3.14159f / 180.f;
+    std::size_t steps = table.rotations.size();
+    for (std::size_t i = 0; i < steps; ++i) {
+        float angle = spreadRadians * ((static_cast<float>(i) + 0.5f) / steps - 0.5f);
+        table.rotations[i] = sf::Vector2f(std::cos(angle), std::sin(angle));
+    }
+    
+    coneTables.push_back(table);
+    return coneTables.back();
+}
+
+bool ParticleSystem::emit(const sf::Vector2f& position, const sf::Vector2f& velocity,
+                          float lifetime, float size, const sf::Color& color) {
+    return pool.spawn(position, velocity, lifetime, size, color);
 }
 
-void ParticleSystem::draw(sf::RenderWindow& window) {
-    // Draw all particles
-    for (auto& particle : particles) {
-        particle->draw(window);
+void ParticleSystem::setQuality(const Quality& newQuality) {
+    quality = newQuality;
+    quality.sides = std::clamp<std::size_t>(quality.sides, 3, MaxParticleSides);
+    emissionBudget = std::min(emissionBudget, quality.maxEmittedPerFrame);
+    buildPolygon(quality.sides);
+}
+
+void ParticleSystem::buildPolygon(std::size_t sides) {
+    for (std::size_t i = 0; i <= sides; ++i) {
+        float angle = 2.f * 3.14159f * static_cast<float>(i) / sides;
+        unitCircle[i] = sf::Vector2f(std::cos(angle), std::sin(angle));
     }
 }
 
-sf::Vector2f ParticleSystem::randomDirectionInCone(const sf::Vector2f& baseDirection, float spreadAngle) {
-    // Convert spread angle to radians
-    float spreadRadians = spreadAngle * 3.14159f / 180.f;
-    
-    // Generate a random angle within the spread
-    std::uniform_real_distribution<float> angleDist(-spreadRadians/2, spreadRadians/2);
-    float angle = angleDist(rng);
+void ParticleSystem::update(float deltaTime) {
+    // Refill the emission budget for the next frame
+    emissionBudget = quality.maxEmittedPerFrame;
     
-    // Normalize base direction
-    float length = std::sqrt(baseDirection.x * baseDirection.x + baseDirection.y * baseDirection.y);
-    sf::Vector2f normalizedBase = length > 0 ? baseDirection / length : sf::Vector2f(0, -1);
+    if (jobSystem && jobSystem->getWorkerCount() > 0 && pool.size() >= 2 * parallelBlockSize) {
+        updateParallel(deltaTime);
+        return;
+    }
     
-    // Calculate direction using rotation matrix
-    float cos_angle = std::cos(angle);
-    float sin_angle = std::sin(angle);
+    // Integrate all particles with the vectorised kernel
+    ParticleKernels::integrate(pool.kernelArrays(), 0, pool.size(), deltaTime);
     
-    sf::Vector2f result;
-    result.x = normalizedBase.x * cos_angle - normalizedBase.y * sin_angle;
-    result.y = normalizedBase.x * sin_angle + normalizedBase.y * cos_angle;
+    // Remove dead particles (the last one takes the freed slot)
+    for (std::size_t i = 0; i < pool.size();) {
+        if (pool.lifetime[i] <= 0.f) {
+            pool.kill(i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+void ParticleSystem::updateParallel(float deltaTime) {
+    std::size_t particleCount = pool.size();
+    std::size_t blockCount = (particleCount + parallelBlockSize - 1) / parallelBlockSize;
+    ParticleKernels::ParticleArrays arrays = pool.kernelArrays();
+    
+    // Integrate and compact every block independently
+    jobSystem->parallelFor(blockCount, 1, [&](std::size_t firstBlock, std::size_t lastBlock) {
+        for (std::size_t block = firstBlock; block < lastBlock; ++block) {
+            std::size_t begin = block * parallelBlockSize;
+            std::size_t end = std::min(particleCount, begin + parallelBlockSize);
+            ParticleKernels::integrate(arrays, begin, end, deltaTime);
+            blockAliveCounts[block] = pool.compactRange(begin, end);
+        }
+    });
+    
+    // Close the gaps between blocks
+    pool.gatherRanges(blockAliveCounts.data(), blockCount, parallelBlockSize);
+}
+
+void ParticleSystem::saveState(State& state) const {
+    state.particleCount = pool.size();
+    state.particles.resize(pool.size() * ParticlePool::BytesPerParticle);
+    pool.saveState(state.particles.data());
+    state.emissionBudget = emissionBudget;
+    state.rng = rng;
+}
+
+void ParticleSystem::restoreState(const State& state) {
+    pool.restoreState(state.particles.data(), state.particleCount);
+    emissionBudget = state.emissionBudget;
+    rng = state.rng;
+}
+
+void ParticleSystem::draw(CountingRenderTarget& target) {
+    if (pool.empty()) return;
+    
+    // Build all particles into one triangle list
+    std::size_t sides = quality.sides;
+    sf::Vertex* vertex = vertices.data();
+    for (std::size_t i = 0; i < pool.size(); ++i) {
+        float remaining = pool.lifetime[i] / pool.initialLifetime[i];
+        
+        // Fade out as lifetime decreases
+        sf::Color color = pool.color[i];
+        color.a = static_cast<uint8_t>(remaining * 255.f);
+        
+        // Shrink slightly as lifetime decreases
+        float radius = pool.radius[i] * (0.8f + remaining * 0.2f);
+        sf::Vector2f center(pool.positionX[i], pool.positionY[i]);
+        
+        for (std::size_t side = 0; side < sides; ++side) {
+            vertex[0].position = center;
+            vertex[1].position = center + unitCircle[side] * radius;
+            vertex[2].position = center + unitCircle[side + 1] * radius;
+            vertex[0].color = vertex[1].color = vertex[2].color = color;
+            vertex += 3;
+        }
+    }
     
-    return result;
-} 
\ No newline at end of file
+    // Draw all particles in a single call
+    target.draw(vertices.data(), pool.size() * sides * 3, sf::PrimitiveType::Triangles);
+}  
\ No newline at end of file
@@ -3,12 +3,44 @@
 #include <SFML/Graphics.hpp>
 #include <vector>
 #include <memory>
-#include "../entities/Particle.hpp"
-#include <random>
+#include <array>
+#include "ParticlePool.hpp"
+#include "../utils/Random.hpp"
+#include "../utils/MemoryTracker.hpp"
+#include "../utils/CountingRenderTarget.hpp"
+
+class JobSystem;
 
 class ParticleSystem {
 public:
-    ParticleSystem();
+    // Property ranges for a burst; each value is drawn uniformly from its range
+    struct EmitterSettings {
+        float minSpeed;
+        float maxSpeed;
+        float minLifetime;
+        float maxLifetime;
+        float minSize;
+        float maxSize;
+        float spread;           // Cone angle in degrees around the emit direction
+        float positionJitter;   // Maximum start offset from the emitter on each axis
+        sf::Color minColor;     // Colour is blended between these by one random weight
+        sf::Color maxColor;
+    };
+    
+    // Cost/quality trade-offs, set from the frame governor
+    struct Quality {
+        float emissionScale;            // Multiplies the particle count of every burst
+        float lifetimeScale;            // Multiplies particle lifetimes
+        std::size_t sides;              // Polygon sides per particle (3 to 8)
+        std::size_t maxEmittedPerFrame; // Particles spawned per update, across all bursts
+    };
+    
+    // Presets used by the create*Particles helpers
+    static const EmitterSettings CollisionEmitter;
+    static const EmitterSettings MovementEmitter;
+    static const EmitterSettings TrailEmitter;
+    
+    explicit ParticleSystem(std::size_t capacity = 4096);
     ~ParticleSystem() = default;
     
     // Create particles at collision point
@@ -20,14 +52,86 @@ public:
     // Create particles that trail behind the ball while it's moving
     void createTrailParticles(const sf::Vector2f& position, const sf::Vector2f& direction, float speed);
     
+    // Spawn a burst of particles in a cone around direction
+    void emitBurst(const EmitterSettings& settings, const sf::Vector2f& position,
+                   const sf::Vector2f& direction, int count);
+    
+    // Add a single particle (dropped if the pool is full)
+    bool emit(const sf::Vector2f& position, const sf::Vector2f& velocity,
+              float lifetime, float size, const sf::Color& color);
+    
+    // Change the emission and render detail
+    void setQuality(const Quality& newQuality);
+    const Quality& getQuality() const { return quality; }
+    
+    // Split large updates across the job system's threads (nullptr to update serially)
+    void setJobSystem(JobSystem* jobs) { jobSystem = jobs; }
+    
     // Update and draw particles
     void update(float deltaTime);
-    void draw(sf::RenderWindow& window);
+    void draw(CountingRenderTarget& target);
+    
+    // Pool usage, for sizing the pool against worst-case bursts
+    std::size_t getParticleCount() const { return pool.size(); }
+    std::size_t getCapacity() const { return pool.capacity(); }
+    std::size_t getHighWaterMark() const { return pool.highWaterMark(); }
+    std::size_t getDroppedCount() const { return pool.droppedCount(); }
+    
+    // Remove every live particle
+    void clear() { pool.clear(); }
+    
+    // Live particles and emitter state, for snapshots
+    struct State {
+        Memory::TaggedVector<std::uint8_t, Memory::Tag::Snapshots> particles;  // Written by ParticlePool::saveState
+        std::size_t particleCount = 0;
+        std::size_t emissionBudget = 0;
+        FastRng rng;
+    };
+    
+    // Copy the particles into state; its buffer is reused, so saving into the same state again doesn't allocate
+    void saveState(State& state) const;
+    void restoreState(const State& state);
     
 private:
-    std::vector<std::unique_ptr<Particle>> particles;
-    std::mt19937 rng;
+    // Rotations spread evenly across one cone angle, so emitting never calls cos/sin
+    struct ConeTable {
+        float spread;
+        std::array<sf::Vector2f, 256> rotations;    // (cos, sin) pairs
+    };
+    
+    // Find the table for a cone angle, building it on first use
+    const ConeTable& getConeTable(float spread);
+    
+    // Precompute the polygon used for every particle
+    void buildPolygon(std::size_t sides);
+    
+    // Parallel update: each block is integrated and compacted on its own, then the blocks are joined
+    void updateParallel(float deltaTime);
+    
+    // Blocks of the parallel update are a quarter of the pool within these bounds;
+    // updates of fewer than two blocks run on the calling thread
+    static constexpr std::size_t MinParallelBlockSize = 1024;
+    static constexpr std::size_t MaxParallelBlockSize = 8192;
+    
+    // Each particle is drawn as a small polygon made of triangles
+    static constexpr std::size_t MaxParticleSides = 8;
+    static constexpr std::size_t MaxVerticesPerParticle = MaxParticleSides * 3;
+    
+    // Random values are generated in batches of this many particles
+    static constexpr std::size_t EmitBatchSize = 64;
+    static constexpr std::size_t RandomsPerParticle = 3;
+    
+    template <typename T>
+    using Buffer = Memory::TaggedVector<T, Memory::Tag::Particles>;
     
-    // Generate a random vector within a cone
-    sf::Vector2f randomDirectionInCone(const sf::Vector2f& baseDirection, float spreadAngle);
+    ParticlePool pool;
+    JobSystem* jobSystem;
+    std::size_t parallelBlockSize;
+    Buffer<std::size_t> blockAliveCounts;                       // Scratch for the parallel update
+    Buffer<sf::Vertex> vertices;                                // Preallocated for a full pool
+    std::array<sf::Vector2f, MaxParticleSides + 1> unitCircle;  // Polygon corners around the origin
+    Quality quality;
+    std::size_t emissionBudget;                                 // Particles left to spawn this update
+    Buffer<ConeTable> coneTables;
+    FastRng rng;
 }; 
\ No newline at end of file
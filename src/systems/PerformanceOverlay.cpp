@@ -0,0 +1,176 @@
+#include "PerformanceOverlay.hpp"
+#include "../core/FrameProfiler.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+
+namespace {
+    // Screen pixels per font dot; glyphs are 3x5 dots on a 4x7 grid
+    const float Dot = 2.f;
+    const float GlyphAdvance = 4.f * Dot;
+    const float LineHeight = 7.f * Dot;
+    
+    // Panel layout in pixels
+    const sf::Vector2f PanelPosition(8.f, 8.f);
+    const float Padding = 8.f;
+    const float BarWidth = 2.f;                                         // One frame in the graph
+    const float PanelWidth = FrameProfiler::HistoryLength * BarWidth + 2.f * Padding;
+    const float GraphHeight = 48.f;                                     // Twice the target frame time
+    const float ValueColumn = 11.f * GlyphAdvance;                      // Where numbers start after a label
+    const float CountColumn = 15.f * GlyphAdvance;                      // Same for the longer count labels
+    const float SectionBarColumn = 18.f * GlyphAdvance;
+    const float SectionBarScale = 100.f;                                // Pixels for one target frame time
+    
+    const sf::Color PanelColor(0, 0, 0, 170);
+    const sf::Color TextColor(235, 235, 235);
+    const sf::Color LabelColor(160, 160, 160);
+    const sf::Color GoodColor(90, 210, 90);
+    const sf::Color WarningColor(235, 200, 60);
+    const sf::Color BadColor(235, 75, 60);
+    const sf::Color TargetColor(255, 255, 255, 90);
+    
+    // Rows top to bottom, '#' for a lit dot
+    struct GlyphRows {
+        char character;
+        const char* rows;
+    };
+    
+    const GlyphRows Font[] = {
+        {'0', "####.##.##.####"}, {'1', ".#.##..#..#.###"}, {'2', "###..#####..###"},
+        {'3', "###..####..####"}, {'4', "#.##.####..#..#"}, {'5', "####..###..####"},
+        {'6', "####..####.####"}, {'7', "###..#..#..#..#"}, {'8', "####.#####.####"},
+        {'9', "####.####..####"}, {'A', "####.#####.##.#"}, {'B', "##.#.###.#.###."},
+        {'C', "####..#..#..###"}, {'D', "##.#.##.##.###."}, {'E', "####..####..###"},
+        {'F', "####..####..#.."}, {'G', "####..#.##.####"}, {'H', "#.##.#####.##.#"},
+        {'I', "###.#..#..#.###"}, {'J', "..#..#..##.####"}, {'K', "#.##.###.#.##.#"},
+        {'L', "#..#..#..#..###"}, {'M', "#.########.##.#"}, {'N', "##.#.##.##.##.#"},
+        {'O', "####.##.##.####"}, {'P', "####.#####..#.."}, {'Q', "####.##.####..#"},
+        {'R', "####.###.#.##.#"}, {'S', "####..###..####"}, {'T', "###.#..#..#..#."},
+        {'U', "#.##.##.##.####"}, {'V', "#.##.##.##.#.#."}, {'W', "#.##.########.#"},
+        {'X', "#.##.#.#.#.##.#"}, {'Y', "#.##.#.#..#..#."}, {'Z', "###..#.#.#..###"},
+        {'.', ".............#."}, {':', "....#.....#...."}, {'/', "..#..#.#.#..#.."},
+        {'%', "#.#..#.#.#..#.#"}, {'-', "......###......"}
+    };
+    
+    sf::Color colorForFrameTime(float milliseconds, float targetMilliseconds) {
+        if (milliseconds <= targetMilliseconds * 1.05f) return GoodColor;
+        if (milliseconds <= targetMilliseconds * 1.5f) return WarningColor;
+        return BadColor;
+    }
+}
+
+PerformanceOverlay::PerformanceOverlay()
+    : glyphs{}
+    , shown(false)
+{
+    for (const GlyphRows& glyph : Font) {
+        std::uint16_t bits = 0;
+        for (int dot = 0; dot < 15; ++dot) {
+            bits = static_cast<std::uint16_t>(bits << 1);
+            if (glyph.rows[dot] == '#') bits |= 1;
+        }
+        glyphs[static_cast<unsigned char>(glyph.character)] = bits;
+    }
+    
+    // A full panel is a few thousand vertices
+    vertices.reserve(8192);
+}
+
+void PerformanceOverlay::update(const FrameProfiler& profiler, float targetFrameTime) {
+    vertices.clear();
+    if (!shown) return;
+    
+    const FrameProfiler::Frame& frame = profiler.getLastFrame();
+    float targetMs = targetFrameTime * 1000.f;
+    char text[64];
+    
+    // Header, graph, one line per section and one per count
+    float panelHeight = Padding * 3.f + LineHeight * (1 + FrameProfiler::SectionCount + FrameProfiler::CounterCount) +
+                        GraphHeight;
+    addRect(PanelPosition, {PanelWidth, panelHeight}, PanelColor);
+    sf::Vector2f cursor = PanelPosition + sf::Vector2f(Padding, Padding);
+    
+    // Frame time and rate
+    float fps = frame.frameTime > 0.f ? 1000.f / frame.frameTime : 0.f;
+    std::snprintf(text, sizeof(text), "%.2f ms  %.0f fps", frame.frameTime, fps);
+    addText(cursor, text, colorForFrameTime(frame.frameTime, targetMs));
+    cursor.y += LineHeight;
+    
+    // Rolling frame times, oldest on the left; the line marks the target
+    const auto& history = profiler.getHistory();
+    float graphBottom = cursor.y + GraphHeight;
+    for (std::size_t i = 0; i < FrameProfiler::HistoryLength; ++i) {
+        float sample = history[(profiler.getHistoryStart() + i) % FrameProfiler::HistoryLength];
+        if (sample <= 0.f) continue;
+        float height = std::min(sample / (targetMs * 2.f), 1.f) * GraphHeight;
+        addRect({cursor.x + i * BarWidth, graphBottom - height}, {BarWidth, height},
+                colorForFrameTime(sample, targetMs));
+    }
+    addRect({cursor.x, graphBottom - GraphHeight / 2.f}, {FrameProfiler::HistoryLength * BarWidth, 1.f}, TargetColor);
+    cursor.y = graphBottom + Padding;
+    
+    // System times, each with a bar relative to the target frame time
+    for (std::size_t i = 0; i < FrameProfiler::SectionCount; ++i) {
+        float milliseconds = frame.sectionTimes[i];
+        addText(cursor, FrameProfiler::getSectionName(static_cast<FrameProfiler::Section>(i)), LabelColor);
+        std::snprintf(text, sizeof(text), "%.2f", milliseconds);
+        addText({cursor.x + ValueColumn, cursor.y}, text, TextColor);
+        float barLength = std::min(milliseconds / targetMs, 1.f) * SectionBarScale;
+        addRect({cursor.x + SectionBarColumn, cursor.y}, {barLength, 5.f * Dot}, GoodColor);
+        cursor.y += LineHeight;
+    }
+    
+    // Counts
+    for (std::size_t i = 0; i < FrameProfiler::CounterCount; ++i) {
+        addText(cursor, FrameProfiler::getCounterName(static_cast<FrameProfiler::Counter>(i)), LabelColor);
+        std::snprintf(text, sizeof(text), "%llu", static_cast<unsigned long long>(frame.counters[i]));
+        addText({cursor.x + CountColumn, cursor.y}, text, TextColor);
+        cursor.y += LineHeight;
+    }
+}
+
+void PerformanceOverlay::draw(CountingRenderTarget& target) {
+    if (!shown || vertices.empty()) return;
+    
+    // Screen pixels, whatever view the game uses
+    sf::View previousView = target.getView();
+    target.setView(sf::View(sf::FloatRect({0.f, 0.f}, sf::Vector2f(target.getSize()))));
+    target.draw(vertices.data(), vertices.size(), sf::PrimitiveType::Triangles);
+    target.setView(previousView);
+}
+
+void PerformanceOverlay::addRect(sf::Vector2f position, sf::Vector2f size, sf::Color color) {
+    sf::Vector2f topRight(position.x + size.x, position.y);
+    sf::Vector2f bottomLeft(position.x, position.y + size.y);
+    sf::Vector2f bottomRight = position + size;
+    
+    vertices.push_back({position, color});
+    vertices.push_back({topRight, color});
+    vertices.push_back({bottomLeft, color});
+    vertices.push_back({bottomLeft, color});
+    vertices.push_back({topRight, color});
+    vertices.push_back({bottomRight, color});
+}
+
+void PerformanceOverlay::addText(sf::Vector2f position, const char* text, sf::Color color) {
+    for (const char* c = text; *c; ++c) {
+        std::uint16_t bits = glyphs[std::toupper(static_cast<unsigned char>(*c)) & 0x7F];
+        
+        // One quad per run of lit dots in a row
+        for (int row = 0; row < 5; ++row) {
+            int rowBits = (bits >> ((4 - row) * 3)) & 0x7;
+            int column = 0;
+            while (column < 3) {
+                if (!(rowBits & (4 >> column))) {
+                    column++;
+                    continue;
+                }
+                int runStart = column;
+                while (column < 3 && (rowBits & (4 >> column))) column++;
+                addRect({position.x + runStart * Dot, position.y + row * Dot},
+                        {(column - runStart) * Dot, Dot}, color);
+            }
+        }
+        position.x += GlyphAdvance;
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "../utils/CountingRenderTarget.hpp"
+
+class FrameProfiler;
+
+// On-screen frame timings: frame time and FPS, a rolling frame-time graph,
+// the time of each system and the entity, particle and draw call counts.
+// Text uses a built-in 3x5 pixel font, so the panel, graph and text are all
+// quads in one vertex array and the overlay costs a single draw call.
+class PerformanceOverlay {
+public:
+    PerformanceOverlay();
+    
+    void setVisible(bool visible) { shown = visible; }
+    bool isVisible() const { return shown; }
+    void toggle() { shown = !shown; }
+    
+    // Rebuild the geometry from the profiler's last frame; targetFrameTime (seconds) scales the graph
+    void update(const FrameProfiler& profiler, float targetFrameTime);
+    
+    // Draw in screen space on top of everything else
+    void draw(CountingRenderTarget& target);
+
+private:
+    void addRect(sf::Vector2f position, sf::Vector2f size, sf::Color color);
+    
+    // Text with its top left corner at position
+    void addText(sf::Vector2f position, const char* text, sf::Color color);
+    
+    // Each glyph is 5 rows of 3 bits, top row in the highest bits
+    std::array<std::uint16_t, 128> glyphs;
+    std::vector<sf::Vertex> vertices;
+    bool shown;
+};
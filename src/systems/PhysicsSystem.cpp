@@ -14,11 +14,13 @@ void PhysicsSystem::update(const std::vector<std::unique_ptr<Entity>>& entities,
     }
 }
 
-void PhysicsSystem::checkCollisions(Ball* ball, const std::vector<Obstacle*>& obstacles) {
-    if (!ball) return;
+int PhysicsSystem::checkCollisions(Ball* ball, const FrameVector<Obstacle*>& obstacles) {
+    if (!ball) return 0;
     
     // Check ball collision against all obstacles
+    int collisions = 0;
     for (auto obstacle : obstacles) {
-        ball->checkCollision(*obstacle);
+        if (ball->checkCollision(*obstacle)) collisions++;
     }
+    return collisions;
 } 
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <SFML/Graphics.hpp>
+#include "../utils/FrameArena.hpp"
 
 class Ball;
 class Obstacle;
@@ -16,8 +17,8 @@ public:
     // Update physics for all entities
     void update(const std::vector<std::unique_ptr<Entity>>& entities, float deltaTime);
     
-    // Handle specific collision between ball and obstacles
-    void checkCollisions(Ball* ball, const std::vector<Obstacle*>& obstacles);
+    // Handle specific collision between ball and obstacles; returns the number resolved
+    int checkCollisions(Ball* ball, const FrameVector<Obstacle*>& obstacles);
     
 private:
     // Physics parameters
@@ -0,0 +1,258 @@
+#include "AssetArchive.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace {
+    std::uint64_t alignOffset(std::uint64_t offset) {
+        return (offset + 7) & ~std::uint64_t(7);
+    }
+    
+    // Shortest back-reference worth encoding
+    const std::size_t MinMatch = 4;
+    const std::size_t MaxOffset = 65535;
+    const int HashBits = 12;
+    
+    std::uint32_t read32(const char* p) {
+        std::uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+    
+    // Lengths that don't fit in a token nibble continue in 255-valued bytes
+    void writeLength(std::vector<char>& out, std::size_t length) {
+        while (length >= 255) {
+            out.push_back(static_cast<char>(255));
+            length -= 255;
+        }
+        out.push_back(static_cast<char>(length));
+    }
+    
+    bool readLength(const unsigned char*& in, const unsigned char* end, std::size_t& length) {
+        unsigned char byte;
+        do {
+            if (in == end) return false;
+            byte = *in++;
+            length += byte;
+        } while (byte == 255);
+        return true;
+    }
+    
+    void writeSequence(std::vector<char>& out, const char* literals, std::size_t literalCount,
+                       std::size_t offset, std::size_t matchLength) {
+        std::size_t matchCode = matchLength ? matchLength - MinMatch : 0;
+        unsigned char token = static_cast<unsigned char>((std::min<std::size_t>(literalCount, 15) << 4) |
+                                                         std::min<std::size_t>(matchCode, 15));
+        out.push_back(static_cast<char>(token));
+        if (literalCount >= 15) writeLength(out, literalCount - 15);
+        out.insert(out.end(), literals, literals + literalCount);
+        
+        // The final sequence has literals only
+        if (matchLength == 0) return;
+        out.push_back(static_cast<char>(offset & 0xFF));
+        out.push_back(static_cast<char>(offset >> 8));
+        if (matchCode >= 15) writeLength(out, matchCode - 15);
+    }
+}
+
+namespace AssetFormat {
+    std::uint64_t hashName(const std::string& name) {
+        std::uint64_t hash = 0xCBF29CE484222325ull;
+        for (char c : name) {
+            hash ^= static_cast<unsigned char>(c == '\\' ? '/' : c);
+            hash *= 0x100000001B3ull;
+        }
+        return hash;
+    }
+    
+    std::vector<char> compress(const char* data, std::size_t size) {
+        std::vector<char> out;
+        out.reserve(size / 2 + 16);
+        
+        // Most recent position of each hashed 4-byte sequence
+        std::vector<std::int64_t> table(std::size_t(1) << HashBits, -1);
+        std::size_t anchor = 0;
+        std::size_t i = 0;
+        
+        while (i + MinMatch <= size) {
+            std::uint32_t sequence = read32(data + i);
+            std::uint32_t hash = (sequence * 2654435761u) >> (32 - HashBits);
+            std::int64_t candidate = table[hash];
+            table[hash] = static_cast<std::int64_t>(i);
+            
+            if (candidate < 0 || i - candidate > MaxOffset || read32(data + candidate) != sequence) {
+                ++i;
+                continue;
+            }
+            
+            std::size_t length = MinMatch;
+            while (i + length < size && data[candidate + length] == data[i + length]) {
+                ++length;
+            }
+            
+            writeSequence(out, data + anchor, i - anchor, i - candidate, length);
+            i += length;
+            anchor = i;
+        }
+        
+        writeSequence(out, data + anchor, size - anchor, 0, 0);
+        return out;
+    }
+    
+    bool decompress(const char* source, std::size_t sourceSize, char* destination, std::size_t destinationSize) {
+        const unsigned char* in = reinterpret_cast<const unsigned char*>(source);
+        const unsigned char* inEnd = in + sourceSize;
+        char* out = destination;
+        char* outEnd = destination + destinationSize;
+        
+        while (in < inEnd) {
+            unsigned char token = *in++;
+            
+            std::size_t literalCount = token >> 4;
+            if (literalCount == 15 && !readLength(in, inEnd, literalCount)) return false;
+            if (literalCount > static_cast<std::size_t>(inEnd - in) ||
+                literalCount > static_cast<std::size_t>(outEnd - out)) return false;
+            std::memcpy(out, in, literalCount);
+            in += literalCount;
+            out += literalCount;
+            
+            if (in == inEnd) break;
+            
+            if (inEnd - in < 2) return false;
+            std::size_t offset = in[0] | (in[1] << 8);
+            in += 2;
+            if (offset == 0 || offset > static_cast<std::size_t>(out - destination)) return false;
+            
+            std::size_t matchLength = token & 15;
+            if (matchLength == 15 && !readLength(in, inEnd, matchLength)) return false;
+            matchLength += MinMatch;
+            if (matchLength > static_cast<std::size_t>(outEnd - out)) return false;
+            
+            // Byte by byte: the match may overlap the bytes it produces
+            const char* match = out - offset;
+            for (std::size_t i = 0; i < matchLength; ++i) {
+                out[i] = match[i];
+            }
+            out += matchLength;
+        }
+        
+        return out == outEnd;
+    }
+}
+
+bool AssetArchive::save(const std::string& filename, const std::vector<File>& files, bool compress) {
+    using namespace AssetFormat;
+    
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+    
+    Header header = {};
+    header.magic = Magic;
+    header.version = Version;
+    header.entryCount = static_cast<std::uint32_t>(files.size());
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    
+    static const char zeros[8] = {};
+    std::vector<Entry> toc;
+    for (const auto& asset : files) {
+        std::uint64_t offset = alignOffset(static_cast<std::uint64_t>(out.tellp()));
+        out.write(zeros, static_cast<std::streamsize>(offset - static_cast<std::uint64_t>(out.tellp())));
+        
+        Entry entry = {};
+        entry.nameHash = hashName(asset.name);
+        entry.offset = offset;
+        entry.size = static_cast<std::uint32_t>(asset.data.size());
+        entry.compression = None;
+        
+        // Keep the compressed form only when it saves at least 10%
+        std::vector<char> packed;
+        if (compress) {
+            packed = AssetFormat::compress(asset.data.data(), asset.data.size());
+            if (packed.size() * 10 <= asset.data.size() * 9) {
+                entry.compression = LZ;
+            }
+        }
+        
+        const std::vector<char>& stored = entry.compression == LZ ? packed : asset.data;
+        entry.storedSize = static_cast<std::uint32_t>(stored.size());
+        out.write(stored.data(), static_cast<std::streamsize>(stored.size()));
+        toc.push_back(entry);
+    }
+    
+    std::sort(toc.begin(), toc.end(), [](const Entry& a, const Entry& b) { return a.nameHash < b.nameHash; });
+    for (std::size_t i = 1; i < toc.size(); ++i) {
+        if (toc[i].nameHash == toc[i - 1].nameHash) return false; // Duplicate name or hash collision
+    }
+    
+    header.tocOffset = alignOffset(static_cast<std::uint64_t>(out.tellp()));
+    out.write(zeros, static_cast<std::streamsize>(header.tocOffset - static_cast<std::uint64_t>(out.tellp())));
+    out.write(reinterpret_cast<const char*>(toc.data()), static_cast<std::streamsize>(toc.size() * sizeof(Entry)));
+    
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    return static_cast<bool>(out);
+}
+
+bool AssetArchive::open(const std::string& filename) {
+    using namespace AssetFormat;
+    
+    header = nullptr;
+    entries = nullptr;
+    if (!file.open(filename)) return false;
+    
+    std::uint64_t fileSize = file.size();
+    if (fileSize < sizeof(Header)) {
+        file.close();
+        return false;
+    }
+    
+    const Header* candidate = reinterpret_cast<const Header*>(file.data());
+    bool valid = candidate->magic == Magic && candidate->version == Version &&
+                 candidate->tocOffset % 8 == 0 && candidate->tocOffset <= fileSize &&
+                 candidate->entryCount <= (fileSize - candidate->tocOffset) / sizeof(Entry);
+    
+    // Every entry's data must lie inside the file
+    const Entry* toc = reinterpret_cast<const Entry*>(file.data() + (valid ? candidate->tocOffset : 0));
+    for (std::uint32_t i = 0; valid && i < candidate->entryCount; ++i) {
+        valid = toc[i].offset <= fileSize && toc[i].storedSize <= fileSize - toc[i].offset &&
+                (toc[i].compression == None ? toc[i].storedSize == toc[i].size : toc[i].compression == LZ);
+    }
+    
+    if (!valid) {
+        file.close();
+        return false;
+    }
+    
+    header = candidate;
+    entries = toc;
+    return true;
+}
+
+const AssetFormat::Entry* AssetArchive::find(const std::string& name) const {
+    if (!header) return nullptr;
+    
+    std::uint64_t hash = AssetFormat::hashName(name);
+    const AssetFormat::Entry* end = entries + header->entryCount;
+    const AssetFormat::Entry* it = std::lower_bound(entries, end, hash,
+        [](const AssetFormat::Entry& entry, std::uint64_t value) { return entry.nameHash < value; });
+    return it != end && it->nameHash == hash ? it : nullptr;
+}
+
+bool AssetArchive::read(const AssetFormat::Entry& entry, const void*& data, std::size_t& size,
+                        std::vector<char>& storage) const {
+    const char* stored = reinterpret_cast<const char*>(file.data() + entry.offset);
+    
+    if (entry.compression == AssetFormat::None) {
+        data = stored;
+        size = entry.size;
+        return true;
+    }
+    
+    storage.resize(entry.size);
+    if (!AssetFormat::decompress(stored, entry.storedSize, storage.data(), storage.size())) {
+        return false;
+    }
+    data = storage.data();
+    size = storage.size();
+    return true;
+}
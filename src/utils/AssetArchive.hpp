@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MappedFile.hpp"
+
+// Packed asset archive (little-endian, 8-byte aligned):
+//
+//   Header
+//   file data                        each entry 8-byte aligned
+//   Entry[entryCount]                table of contents, sorted by name hash
+//
+// Files are looked up by a hash of their path, so the archive stores no names.
+// Entries can be stored compressed with a small LZ77 codec; uncompressed
+// entries are read straight from the mapping without copying.
+namespace AssetFormat {
+    const std::uint32_t Magic = 0x4B50474D;   // "MGPK"
+    const std::uint32_t Version = 1;
+    
+    enum Compression : std::uint32_t {
+        None = 0,
+        LZ = 1
+    };
+    
+    struct Header {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t entryCount;
+        std::uint32_t reserved;
+        std::uint64_t tocOffset;
+    };
+    
+    struct Entry {
+        std::uint64_t nameHash;
+        std::uint64_t offset;
+        std::uint32_t storedSize;
+        std::uint32_t size;             // Size after decompression
+        std::uint32_t compression;
+        std::uint32_t reserved;
+    };
+    
+    static_assert(sizeof(Header) == 24, "Header must be packed");
+    static_assert(sizeof(Entry) == 32, "Entry must be packed");
+    
+    // FNV-1a over the path, with '\' treated as '/'
+    std::uint64_t hashName(const std::string& name);
+    
+    // LZ77 block codec (LZ4-style sequences of literals and back-references)
+    std::vector<char> compress(const char* data, std::size_t size);
+    bool decompress(const char* source, std::size_t sourceSize, char* destination, std::size_t destinationSize);
+}
+
+// An asset archive mapped into memory. Lookups are a binary search over the
+// mapped table of contents; read-only, so it is safe to use from any thread.
+class AssetArchive {
+public:
+    struct File {
+        std::string name;
+        std::vector<char> data;
+    };
+    
+    AssetArchive() = default;
+    
+    // Write files to an archive, compressing those that shrink by at least 10% when compress is set
+    static bool save(const std::string& filename, const std::vector<File>& files, bool compress);
+    
+    // Map and validate an archive
+    bool open(const std::string& filename);
+    bool isOpen() const { return file.isOpen(); }
+    std::uint32_t getEntryCount() const { return header ? header->entryCount : 0; }
+    
+    // Table of contents entry for a path, nullptr if the archive doesn't contain it
+    const AssetFormat::Entry* find(const std::string& name) const;
+    
+    // Contents of an entry. Uncompressed entries point into the mapping and leave
+    // storage untouched; compressed ones are decoded into storage.
+    bool read(const AssetFormat::Entry& entry, const void*& data, std::size_t& size,
+              std::vector<char>& storage) const;
+
+private:
+    MappedFile file;
+    const AssetFormat::Header* header = nullptr;
+    const AssetFormat::Entry* entries = nullptr;
+};
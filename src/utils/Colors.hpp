@@ -15,4 +15,5 @@ namespace Colors {
     // Ball colors
     const sf::Color BallColor = sf::Color::White;           // Ball color
     const sf::Color DragLineColor = sf::Color::Red;         // Color for the drag line
+    const sf::Color GhostColor = sf::Color(255, 255, 255, 90);  // Translucent ball of a ghost run
 } 
\ No newline at end of file
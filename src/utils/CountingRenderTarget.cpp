@@ -0,0 +1,125 @@
+#include "CountingRenderTarget.hpp"
+
+void RenderPassStats::add(const RenderPassStats& other) {
+    drawCalls += other.drawCalls;
+    vertices += other.vertices;
+    textureSwitches += other.textureSwitches;
+    stateSwitches += other.stateSwitches;
+    for (std::size_t i = 0; i < PrimitiveTypeCount; ++i) {
+        primitiveDraws[i] += other.primitiveDraws[i];
+    }
+}
+
+CountingRenderTarget::CountingRenderTarget(sf::RenderTarget* target)
+    : target(target)
+    , currentPass(0)
+    , hasLastDraw(false)
+    , lastTexture(nullptr)
+    , lastShader(nullptr)
+{
+}
+
+void CountingRenderTarget::setTarget(sf::RenderTarget* newTarget) {
+    target = newTarget;
+}
+
+void CountingRenderTarget::beginPass(Pass pass) {
+    currentPass = static_cast<std::size_t>(pass);
+}
+
+void CountingRenderTarget::resetStats() {
+    passes.fill(RenderPassStats());
+    currentPass = 0;
+    hasLastDraw = false;
+}
+
+RenderPassStats CountingRenderTarget::getTotals() const {
+    RenderPassStats totals;
+    for (const RenderPassStats& pass : passes) {
+        totals.add(pass);
+    }
+    return totals;
+}
+
+void CountingRenderTarget::clear(sf::Color color) {
+    if (target) target->clear(color);
+}
+
+void CountingRenderTarget::setView(const sf::View& newView) {
+    view = newView;
+    if (target) target->setView(newView);
+}
+
+const sf::View& CountingRenderTarget::getView() const {
+    return target ? target->getView() : view;
+}
+
+sf::Vector2u CountingRenderTarget::getSize() const {
+    return target ? target->getSize() : sf::Vector2u(0, 0);
+}
+
+void CountingRenderTarget::draw(const sf::Shape& shape, const sf::RenderStates& states) {
+    // SFML draws the fill as a fan and the outline, if any, as an untextured strip
+    std::size_t points = shape.getPointCount();
+    count(points + 2, sf::PrimitiveType::TriangleFan, shape.getTexture(), states);
+    if (shape.getOutlineThickness() != 0.f) {
+        count((points + 1) * 2, sf::PrimitiveType::TriangleStrip, nullptr, states);
+    }
+    
+    if (target) target->draw(shape, states);
+}
+
+void CountingRenderTarget::draw(const sf::Sprite& sprite, const sf::RenderStates& states) {
+    count(4, sf::PrimitiveType::TriangleStrip, &sprite.getTexture(), states);
+    if (target) target->draw(sprite, states);
+}
+
+void CountingRenderTarget::draw(const sf::Vertex* vertices, std::size_t vertexCount, sf::PrimitiveType type,
+                                const sf::RenderStates& states) {
+    count(vertexCount, type, states.texture, states);
+    if (target) target->draw(vertices, vertexCount, type, states);
+}
+
+void CountingRenderTarget::count(std::size_t vertexCount, sf::PrimitiveType type, const sf::Texture* texture,
+                                 const sf::RenderStates& states) {
+    RenderPassStats& stats = passes[currentPass];
+    stats.drawCalls++;
+    stats.vertices += vertexCount;
+    stats.primitiveDraws[static_cast<std::size_t>(type)]++;
+    
+    // The first draw of a frame has nothing to switch from
+    if (hasLastDraw) {
+        if (texture != lastTexture) stats.textureSwitches++;
+        if (states.shader != lastShader || states.blendMode != lastBlendMode) stats.stateSwitches++;
+    }
+    hasLastDraw = true;
+    lastTexture = texture;
+    lastShader = states.shader;
+    lastBlendMode = states.blendMode;
+}
+
+const char* CountingRenderTarget::getPassName(Pass pass) {
+    switch (pass) {
+        case Pass::Background: return "background";
+        case Pass::Shadows: return "shadows";
+        case Pass::Particles: return "particles";
+        case Pass::Ghosts: return "ghosts";
+        case Pass::Entities: return "entities";
+        case Pass::Upscale: return "upscale";
+        case Pass::Overlays: return "overlays";
+        case Pass::Hud: return "hud";
+        default: return "unknown";
+    }
+}
+
+const char* CountingRenderTarget::getPrimitiveName(sf::PrimitiveType type) {
+    switch (type) {
+        case sf::PrimitiveType::Points: return "points";
+        case sf::PrimitiveType::Lines: return "lines";
+        case sf::PrimitiveType::LineStrip: return "line strip";
+        case sf::PrimitiveType::Triangles: return "triangles";
+        case sf::PrimitiveType::TriangleStrip: return "triangle strip";
+        case sf::PrimitiveType::TriangleFan: return "triangle fan";
+        default: return "unknown";
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Draws submitted during one render pass
+struct RenderPassStats {
+    static const std::size_t PrimitiveTypeCount = 6;    // Points through TriangleFan
+    
+    std::uint32_t drawCalls = 0;
+    std::uint64_t vertices = 0;
+    std::uint32_t textureSwitches = 0;      // Draws with a different texture than the draw before
+    std::uint32_t stateSwitches = 0;        // Draws with a different blend mode or shader
+    std::array<std::uint32_t, PrimitiveTypeCount> primitiveDraws{};    // Draw calls per sf::PrimitiveType
+    
+    void add(const RenderPassStats& other);
+};
+
+// Passes the draws of a frame to an sf::RenderTarget and counts them, per
+// render pass: draw calls, vertices, primitive types and texture and state
+// switches. Shapes and sprites count as the draw calls SFML makes for them,
+// so a shape with an outline is two. Without a target draws are only
+// counted, which lets a headless game measure what its frames would submit.
+class CountingRenderTarget {
+public:
+    enum class Pass {
+        Background,
+        Shadows,
+        Particles,
+        Ghosts,
+        Entities,
+        Upscale,        // Downscaled scene stretched over the window
+        Overlays,       // Entity overlays at native resolution
+        Hud,            // Performance overlay
+        Count
+    };
+    
+    static const std::size_t PassCount = static_cast<std::size_t>(Pass::Count);
+    
+    explicit CountingRenderTarget(sf::RenderTarget* target = nullptr);
+    
+    // Target of the following draws (nullptr to only count them)
+    void setTarget(sf::RenderTarget* newTarget);
+    sf::RenderTarget* getTarget() const { return target; }
+    
+    // Count the following draws against pass
+    void beginPass(Pass pass);
+    
+    // Start counting a new frame
+    void resetStats();
+    
+    const RenderPassStats& getPassStats(Pass pass) const { return passes[static_cast<std::size_t>(pass)]; }
+    RenderPassStats getTotals() const;
+    
+    static const char* getPassName(Pass pass);
+    static const char* getPrimitiveName(sf::PrimitiveType type);
+    
+    // The parts of sf::RenderTarget the game draws with
+    void clear(sf::Color color = sf::Color::Black);
+    void setView(const sf::View& newView);
+    const sf::View& getView() const;
+    sf::Vector2u getSize() const;
+    
+    void draw(const sf::Shape& shape, const sf::RenderStates& states = sf::RenderStates::Default);
+    void draw(const sf::Sprite& sprite, const sf::RenderStates& states = sf::RenderStates::Default);
+    void draw(const sf::Vertex* vertices, std::size_t vertexCount, sf::PrimitiveType type,
+              const sf::RenderStates& states = sf::RenderStates::Default);
+
+private:
+    void count(std::size_t vertexCount, sf::PrimitiveType type, const sf::Texture* texture,
+               const sf::RenderStates& states);
+    
+    sf::RenderTarget* target;
+    sf::View view;      // View when there is no target
+    
+    std::size_t currentPass;
+    std::array<RenderPassStats, PassCount> passes;
+    
+    // State of the previous draw, to spot switches
+    bool hasLastDraw;
+    const sf::Texture* lastTexture;
+    const sf::Shader* lastShader;
+    sf::BlendMode lastBlendMode;
+};
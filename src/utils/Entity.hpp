@@ -1,14 +1,25 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
+#include "CountingRenderTarget.hpp"
+#include "MemoryTracker.hpp"
 
 class Entity {
 public:
     virtual ~Entity() = default;
     
+    // Entity objects are counted as entity memory
+    static void* operator new(std::size_t size) { return Memory::allocate(Memory::Tag::Entities, size); }
+    static void operator delete(void* pointer, std::size_t size) {
+        Memory::deallocate(Memory::Tag::Entities, pointer, size);
+    }
+    
     virtual void update(float deltaTime) = 0;
-    virtual void draw(sf::RenderWindow& window) = 0;
-    virtual void drawShadow(sf::RenderWindow& window) = 0;
+    virtual void draw(CountingRenderTarget& target) = 0;
+    virtual void drawShadow(CountingRenderTarget& target) = 0;
+    
+    // Drawn at native resolution on top of the (possibly downscaled) scene, in world coordinates
+    virtual void drawOverlay(CountingRenderTarget& target) {}
     virtual bool handleMousePress(const sf::Vector2f& mousePos) { return false; }
     virtual bool handleMouseRelease(const sf::Vector2f& mousePos) { return false; }
     virtual bool handleMouseMove(const sf::Vector2f& mousePos) { return false; }
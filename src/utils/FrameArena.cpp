@@ -0,0 +1,79 @@
+#include "FrameArena.hpp"
+#include "MemoryTracker.hpp"
+#include <algorithm>
+#include <cstdint>
+
+FrameArena::FrameArena(std::size_t capacity)
+    : buffer(static_cast<unsigned char*>(Memory::allocate(Memory::Tag::FrameArena, capacity)))
+    , capacity(capacity)
+    , used(0)
+    , overflow(nullptr)
+    , overflowCount(0)
+#ifndef NDEBUG
+    , frameBytes(0)
+    , peak(0)
+#endif
+{
+}
+
+FrameArena::~FrameArena() {
+    reset();
+    Memory::deallocate(Memory::Tag::FrameArena, buffer, capacity);
+}
+
+void* FrameArena::allocate(std::size_t bytes, std::size_t alignment) {
+#ifndef NDEBUG
+    frameBytes += bytes;
+    peak = std::max(peak, frameBytes);
+#endif
+    
+    // Align the address, not the offset, so over-aligned types work too
+    std::uintptr_t base = reinterpret_cast<std::uintptr_t>(buffer);
+    std::uintptr_t aligned = (base + used + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+    std::size_t offset = static_cast<std::size_t>(aligned - base);
+    if (offset + bytes <= capacity) {
+        used = offset + bytes;
+        return buffer + offset;
+    }
+    
+    // Out of space: take it from the heap until the end of the frame
+    // (the block header keeps the allocation aligned to max_align_t)
+    void* block = Memory::allocate(Memory::Tag::FrameArena, sizeof(OverflowBlock) + bytes);
+    OverflowBlock* header = static_cast<OverflowBlock*>(block);
+    header->next = overflow;
+    header->size = sizeof(OverflowBlock) + bytes;
+    overflow = header;
+    overflowCount++;
+    return header + 1;
+}
+
+void FrameArena::deallocate(void* pointer, std::size_t bytes) {
+    // Only the top of the buffer can be handed back
+    // (overflow blocks never match, they're outside the buffer)
+    std::uintptr_t start = reinterpret_cast<std::uintptr_t>(pointer);
+    std::uintptr_t top = reinterpret_cast<std::uintptr_t>(buffer) + used;
+    if (start + bytes == top && start >= reinterpret_cast<std::uintptr_t>(buffer)) {
+        used = static_cast<std::size_t>(start - reinterpret_cast<std::uintptr_t>(buffer));
+    }
+}
+
+void FrameArena::reset() {
+    while (overflow) {
+        OverflowBlock* next = overflow->next;
+        Memory::deallocate(Memory::Tag::FrameArena, overflow, overflow->size);
+        overflow = next;
+    }
+    used = 0;
+
+#ifndef NDEBUG
+    frameBytes = 0;
+#endif
+}
+
+std::size_t FrameArena::getPeak() const {
+#ifndef NDEBUG
+    return peak;
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// Linear allocator for data that only lives for one frame. Allocating bumps a
+// pointer through a fixed buffer; nothing is freed individually, the whole
+// arena is released at once by reset() at the end of the frame. Requests that
+// don't fit fall back to the heap (and are freed by the next reset), so an
+// undersized arena is slow but never wrong. Not thread-safe: one arena per thread.
+class FrameArena {
+public:
+    static const std::size_t DefaultCapacity = 64 * 1024;
+    
+    explicit FrameArena(std::size_t capacity = DefaultCapacity);
+    ~FrameArena();
+    
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+    
+    // Memory for bytes bytes, valid until the next reset()
+    void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t));
+    
+    // Give back the most recent allocation (so a growing vector can reuse its space).
+    // Anything else is only reclaimed by reset().
+    void deallocate(void* pointer, std::size_t bytes);
+    
+    // Release everything allocated since the last reset
+    void reset();
+    
+    std::size_t getUsed() const { return used; }
+    std::size_t getCapacity() const { return capacity; }
+    
+    // Allocations that didn't fit and went to the heap, since the arena was created
+    std::size_t getOverflowCount() const { return overflowCount; }
+    
+    // Most bytes requested in a single frame, overflow included (debug builds only, 0 otherwise)
+    std::size_t getPeak() const;
+
+private:
+    // Heap block for an allocation that didn't fit, chained for the next reset
+    struct alignas(std::max_align_t) OverflowBlock {
+        OverflowBlock* next;
+        std::size_t size;
+    };
+    
+    unsigned char* buffer;
+    std::size_t capacity;
+    std::size_t used;
+    OverflowBlock* overflow;
+    std::size_t overflowCount;
+
+#ifndef NDEBUG
+    std::size_t frameBytes;     // Requested since the last reset
+    std::size_t peak;
+#endif
+};
+
+// STL allocator drawing from a FrameArena. Without an arena it uses the heap,
+// so code written against it also works where no frame arena is available.
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+    
+    ArenaAllocator(FrameArena* arena = nullptr) noexcept : arena(arena) {}
+    
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.getArena()) {}
+    
+    T* allocate(std::size_t count) {
+        if (!arena) {
+            return static_cast<T*>(::operator new(count * sizeof(T)));
+        }
+        return static_cast<T*>(arena->allocate(count * sizeof(T), alignof(T)));
+    }
+    
+    void deallocate(T* pointer, std::size_t count) noexcept {
+        if (!arena) {
+            ::operator delete(pointer);
+            return;
+        }
+        arena->deallocate(pointer, count * sizeof(T));
+    }
+    
+    FrameArena* getArena() const noexcept { return arena; }
+
+private:
+    FrameArena* arena;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return a.getArena() == b.getArena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return !(a == b);
+}
+
+// Vector whose storage lives until the end of the frame
+template <typename T>
+using FrameVector = std::vector<T, ArenaAllocator<T>>;
@@ -0,0 +1,104 @@
+#include "MappedFile.hpp"
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : mapping(std::exchange(other.mapping, nullptr))
+    , length(std::exchange(other.length, 0))
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        mapping = std::exchange(other.mapping, nullptr);
+        length = std::exchange(other.length, 0);
+    }
+    return *this;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& filename) {
+    close();
+    
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    
+    HANDLE fileMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!fileMapping) return false;
+    
+    // The view keeps the mapping alive, so both handles can be closed right away
+    void* view = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(fileMapping);
+    if (!view) return false;
+    
+    mapping = static_cast<const std::uint8_t*>(view);
+    length = static_cast<std::size_t>(fileSize.QuadPart);
+    return true;
+}
+
+void MappedFile::close() {
+    if (mapping) {
+        UnmapViewOfFile(mapping);
+        mapping = nullptr;
+        length = 0;
+    }
+}
+
+#else
+
+bool MappedFile::open(const std::string& filename) {
+    close();
+    
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+    
+    // The mapping stays valid after the descriptor is closed
+    void* view = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) return false;
+    
+    mapping = static_cast<const std::uint8_t*>(view);
+    length = static_cast<std::size_t>(info.st_size);
+    return true;
+}
+
+void MappedFile::close() {
+    if (mapping) {
+        munmap(const_cast<std::uint8_t*>(mapping), length);
+        mapping = nullptr;
+        length = 0;
+    }
+}
+
+#endif
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Read-only memory mapping of a whole file. The data stays valid until the
+// MappedFile is closed or destroyed.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    
+    // Map a file into memory, returns false if it can't be opened or is empty
+    bool open(const std::string& filename);
+    void close();
+    
+    bool isOpen() const { return mapping != nullptr; }
+    const std::uint8_t* data() const { return mapping; }
+    std::size_t size() const { return length; }
+
+private:
+    const std::uint8_t* mapping = nullptr;
+    std::size_t length = 0;
+};
@@ -0,0 +1,110 @@
+#include "MemoryTracker.hpp"
+#include <array>
+#include <atomic>
+#include <iomanip>
+
+namespace {
+    struct Counters {
+        std::atomic<std::size_t> liveBytes{0};
+        std::atomic<std::size_t> peakBytes{0};
+        std::atomic<std::uint64_t> liveAllocations{0};
+        std::atomic<std::uint64_t> totalAllocations{0};
+    };
+    
+    const std::size_t TagCount = static_cast<std::size_t>(Memory::Tag::Count);
+    
+    // Function-local so allocations made during static initialisation are counted safely
+    std::array<Counters, TagCount>& counters() {
+        static std::array<Counters, TagCount> instance;
+        return instance;
+    }
+    
+    Counters& countersFor(Memory::Tag tag) {
+        return counters()[static_cast<std::size_t>(tag)];
+    }
+}
+
+namespace Memory {
+    void recordAllocation(Tag tag, std::size_t bytes) {
+        Counters& tagCounters = countersFor(tag);
+        std::size_t live = tagCounters.liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        tagCounters.liveAllocations.fetch_add(1, std::memory_order_relaxed);
+        tagCounters.totalAllocations.fetch_add(1, std::memory_order_relaxed);
+        
+        // Raise the peak unless another thread already raised it further
+        std::size_t peak = tagCounters.peakBytes.load(std::memory_order_relaxed);
+        while (live > peak && !tagCounters.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        }
+    }
+    
+    void recordFree(Tag tag, std::size_t bytes) {
+        Counters& tagCounters = countersFor(tag);
+        tagCounters.liveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+        tagCounters.liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+    }
+    
+    void* allocate(Tag tag, std::size_t bytes) {
+        void* pointer = ::operator new(bytes);
+        recordAllocation(tag, bytes);
+        return pointer;
+    }
+    
+    void deallocate(Tag tag, void* pointer, std::size_t bytes) {
+        if (!pointer) return;
+        recordFree(tag, bytes);
+        ::operator delete(pointer);
+    }
+    
+    TagStats getStats(Tag tag) {
+        const Counters& tagCounters = countersFor(tag);
+        
+        TagStats stats;
+        stats.liveBytes = tagCounters.liveBytes.load(std::memory_order_relaxed);
+        stats.peakBytes = tagCounters.peakBytes.load(std::memory_order_relaxed);
+        stats.liveAllocations = tagCounters.liveAllocations.load(std::memory_order_relaxed);
+        stats.totalAllocations = tagCounters.totalAllocations.load(std::memory_order_relaxed);
+        return stats;
+    }
+    
+    std::uint64_t getTotalAllocations() {
+        std::uint64_t total = 0;
+        for (const Counters& tagCounters : counters()) {
+            total += tagCounters.totalAllocations.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+    
+    const char* getTagName(Tag tag) {
+        switch (tag) {
+            case Tag::Entities: return "entities";
+            case Tag::Particles: return "particles";
+            case Tag::Generation: return "generation";
+            case Tag::Resources: return "resources";
+            case Tag::FrameArena: return "frame arena";
+            case Tag::Ghosts: return "ghosts";
+            case Tag::Snapshots: return "snapshots";
+            default: return "unknown";
+        }
+    }
+    
+    void writeReport(std::ostream& out) {
+        // Leave the caller's number formatting as it was
+        std::ios_base::fmtflags flags = out.flags();
+        std::streamsize precision = out.precision();
+        
+        out << "Memory (KB)            live       peak  live allocs  allocations\n";
+        out << std::fixed << std::setprecision(1);
+        for (std::size_t i = 0; i < TagCount; ++i) {
+            Tag tag = static_cast<Tag>(i);
+            TagStats stats = getStats(tag);
+            out << "  " << std::left << std::setw(14) << getTagName(tag) << std::right
+                << std::setw(11) << stats.liveBytes / 1024.0
+                << std::setw(11) << stats.peakBytes / 1024.0
+                << std::setw(13) << stats.liveAllocations
+                << std::setw(13) << stats.totalAllocations << "\n";
+        }
+        
+        out.flags(flags);
+        out.precision(precision);
+    }
+}
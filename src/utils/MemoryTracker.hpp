@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <ostream>
+#include <vector>
+
+// Heap usage broken down by the system that owns it. Containers opt in with
+// TaggedAllocator, classes with a tagged operator new (see Entity), and
+// anything else reports its own sizes with recordAllocation/recordFree.
+// Counters are atomic, so any thread can allocate.
+namespace Memory {
+    enum class Tag {
+        Entities,       // Ball and obstacle objects
+        Particles,      // Particle pool and vertex buffers
+        Generation,     // Course chunk bookkeeping and walls waiting to be built
+        Resources,      // Resident size of loaded textures, fonts and sounds
+        FrameArena,     // Frame arena buffer and its overflow blocks
+        Ghosts,         // Recorded and loaded ghost tracks
+        Snapshots,      // World snapshots kept for undo
+        Count
+    };
+    
+    struct TagStats {
+        std::size_t liveBytes = 0;
+        std::size_t peakBytes = 0;
+        std::uint64_t liveAllocations = 0;
+        std::uint64_t totalAllocations = 0;
+    };
+    
+    void recordAllocation(Tag tag, std::size_t bytes);
+    void recordFree(Tag tag, std::size_t bytes);
+    
+    // Heap memory counted against tag
+    void* allocate(Tag tag, std::size_t bytes);
+    void deallocate(Tag tag, void* pointer, std::size_t bytes);
+    
+    TagStats getStats(Tag tag);
+    const char* getTagName(Tag tag);
+    
+    // Allocations made so far across all tags
+    std::uint64_t getTotalAllocations();
+    
+    // One line per tag with live and peak bytes and allocation counts
+    void writeReport(std::ostream& out);
+    
+    // STL allocator that counts its memory against a tag
+    template <typename T, Tag tag>
+    class TaggedAllocator {
+    public:
+        using value_type = T;
+        
+        template <typename U>
+        struct rebind {
+            using other = TaggedAllocator<U, tag>;
+        };
+        
+        TaggedAllocator() noexcept = default;
+        
+        template <typename U>
+        TaggedAllocator(const TaggedAllocator<U, tag>&) noexcept {}
+        
+        T* allocate(std::size_t count) {
+            return static_cast<T*>(Memory::allocate(tag, count * sizeof(T)));
+        }
+        
+        void deallocate(T* pointer, std::size_t count) noexcept {
+            Memory::deallocate(tag, pointer, count * sizeof(T));
+        }
+    };
+    
+    template <typename T, typename U, Tag tag>
+    bool operator==(const TaggedAllocator<T, tag>&, const TaggedAllocator<U, tag>&) { return true; }
+    
+    template <typename T, typename U, Tag tag>
+    bool operator!=(const TaggedAllocator<T, tag>&, const TaggedAllocator<U, tag>&) { return false; }
+    
+    template <typename T, Tag tag>
+    using TaggedVector = std::vector<T, TaggedAllocator<T, tag>>;
+}
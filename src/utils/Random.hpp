@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Counter-based random numbers: every value is a pure function of
+// (seed, key, counter), so nothing depends on what was drawn before it.
+namespace Random {
+    // SplitMix64 finaliser - a cheap, well-distributed 64-bit mix
+    inline std::uint64_t mix(std::uint64_t x) {
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+    
+    // Hash a (seed, key, counter) triple into 64 random bits
+    inline std::uint64_t hash(std::uint64_t seed, std::int64_t key, std::uint64_t counter) {
+        std::uint64_t h = mix(seed ^ mix(static_cast<std::uint64_t>(key)));
+        return mix(h ^ mix(counter + 0x632BE59BD9B4E019ull));
+    }
+    
+    // Map random bits to a float in [0, 1)
+    inline float toUnitFloat(std::uint64_t bits) {
+        return static_cast<float>(bits >> 40) * (1.0f / 16777216.0f);
+    }
+}
+
+// Random stream keyed on (seed, key). Draws are numbered, so the same key
+// always produces the same sequence regardless of generation order.
+class CounterRng {
+public:
+    CounterRng(std::uint64_t seed, std::int64_t key)
+        : seed(seed)
+        , key(key)
+        , counter(0)
+    {
+    }
+    
+    std::uint64_t next() { return Random::hash(seed, key, counter++); }
+    
+    // Uniform float in [min, max)
+    float uniform(float min, float max) {
+        return min + (max - min) * Random::toUnitFloat(next());
+    }
+    
+    // Uniform integer in [min, max]
+    int uniformInt(int min, int max) {
+        std::uint64_t range = static_cast<std::uint64_t>(max - min) + 1;
+        return min + static_cast<int>(next() % range);
+    }
+
+private:
+    std::uint64_t seed;
+    std::int64_t key;
+    std::uint64_t counter;
+};
+
+// Small, fast sequential generator (xoshiro128++) for effects that don't need
+// to be reproducible, such as particles. Far cheaper than std::mt19937 and
+// std::uniform_*_distribution, and can fill a whole buffer at once.
+class FastRng {
+public:
+    explicit FastRng(std::uint64_t seed = 0) { reseed(seed); }
+    
+    // Expand the seed into the 128-bit state with SplitMix64
+    void reseed(std::uint64_t seed) {
+        std::uint64_t a = Random::mix(seed);
+        std::uint64_t b = Random::mix(seed + 1);
+        state[0] = static_cast<std::uint32_t>(a);
+        state[1] = static_cast<std::uint32_t>(a >> 32);
+        state[2] = static_cast<std::uint32_t>(b);
+        state[3] = static_cast<std::uint32_t>(b >> 32);
+    }
+    
+    std::uint32_t next() {
+        std::uint32_t result = rotl(state[0] + state[3], 7) + state[0];
+        std::uint32_t t = state[1] << 9;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 11);
+        return result;
+    }
+    
+    // Generate a batch of values in one tight loop
+    void fill(std::uint32_t* out, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] = next();
+        }
+    }
+    
+    // Map 32 random bits to a float in [0, 1)
+    static float toUnitFloat(std::uint32_t bits) {
+        return static_cast<float>(bits >> 8) * (1.0f / 16777216.0f);
+    }
+    
+    // Map the low 16 bits to a float in [0, 1), so one draw can feed two values
+    static float toUnitFloat16(std::uint32_t bits) {
+        return static_cast<float>(bits & 0xFFFF) * (1.0f / 65536.0f);
+    }
+    
+    // Map 32 random bits to an integer in [min, max] without a division
+    static int toRange(std::uint32_t bits, int min, int max) {
+        std::uint64_t range = static_cast<std::uint64_t>(max - min) + 1;
+        return min + static_cast<int>((bits * range) >> 32);
+    }
+    
+    // Uniform float in [min, max)
+    float uniform(float min, float max) {
+        return min + (max - min) * toUnitFloat(next());
+    }
+    
+    // Uniform integer in [min, max]
+    int uniformInt(int min, int max) { return toRange(next(), min, max); }
+
+private:
+    static std::uint32_t rotl(std::uint32_t x, int k) {
+        return (x << k) | (x >> (32 - k));
+    }
+    
+    std::uint32_t state[4];
+};
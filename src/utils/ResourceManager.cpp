@@ -0,0 +1,485 @@
+#include "ResourceManager.hpp"
+#include "MemoryTracker.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+namespace {
+    // File contents from the mounted archive; compressed entries are decoded into storage.
+    // Returns false if the archive doesn't have the file.
+    bool readFromArchive(const std::string& filename, const void*& data, std::size_t& size,
+                         std::vector<char>& storage) {
+        const AssetArchive& archive = ResourceManager::getInstance().getArchive();
+        const AssetFormat::Entry* entry = archive.find(filename);
+        return entry && archive.read(*entry, data, size, storage);
+    }
+}
+
+namespace Resources {
+    bool TextureSlot::decode() {
+        const void* fileData;
+        std::size_t fileSize;
+        std::vector<char> storage;
+        if (readFromArchive(filename, fileData, fileSize, storage)) {
+            return image.loadFromMemory(fileData, fileSize);
+        }
+        return image.loadFromFile(filename);
+    }
+    
+    bool TextureSlot::upload() {
+        bool loaded = value.loadFromImage(image);
+        bytes = static_cast<std::size_t>(image.getSize().x) * image.getSize().y * 4;
+        image = sf::Image();    // The pixels live on the GPU now
+        return loaded;
+    }
+    
+    bool FontSlot::decode() {
+        // Uncompressed archive entries are used in place, without a copy
+        if (readFromArchive(filename, source, sourceSize, data)) {
+            return true;
+        }
+        
+        std::ifstream file(filename, std::ios::binary);
+        if (!file) return false;
+        data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        source = data.data();
+        sourceSize = data.size();
+        return !data.empty();
+    }
+    
+    bool FontSlot::upload() {
+        bytes = sourceSize;
+        return value.openFromMemory(source, sourceSize);
+    }
+    
+    bool SoundSlot::decode() {
+        const void* fileData;
+        std::size_t fileSize;
+        std::vector<char> storage;
+        sf::InputSoundFile file;
+        
+        bool opened = readFromArchive(filename, fileData, fileSize, storage)
+            ? file.openFromMemory(fileData, fileSize)
+            : file.openFromFile(filename);
+        if (!opened) return false;
+        
+        samples.resize(static_cast<std::size_t>(file.getSampleCount()));
+        samples.resize(static_cast<std::size_t>(file.read(samples.data(), samples.size())));
+        channelCount = file.getChannelCount();
+        sampleRate = file.getSampleRate();
+        channelMap = file.getChannelMap();
+        return true;
+    }
+    
+    bool SoundSlot::upload() {
+        bool loaded = value.loadFromSamples(samples.data(), samples.size(), channelCount, sampleRate, channelMap);
+        bytes = samples.size() * sizeof(std::int16_t);
+        std::vector<std::int16_t>().swap(samples);    // SoundBuffer keeps its own copy
+        return loaded;
+    }
+    
+    bool AtlasSlot::decode() {
+        const void* fileData;
+        std::size_t fileSize;
+        std::vector<char> storage;
+        if (readFromArchive(filename, fileData, fileSize, storage)) {
+            return image.loadFromMemory(fileData, fileSize);
+        }
+        return image.loadFromFile(filename);
+    }
+    
+    bool AtlasSlot::upload() {
+        std::optional<AtlasRegion> region = ResourceManager::getInstance().getAtlas().add(filename, image);
+        image = sf::Image();
+        if (!region) return false;
+        value = *region;
+        bytes = static_cast<std::size_t>(region->rect.size.x) * region->rect.size.y * 4;
+        return true;
+    }
+}
+
+ResourceManager::~ResourceManager() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueCondition.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+TextureHandle ResourceManager::loadTextureAsync(const std::string& filename) {
+    return TextureHandle(acquire(textures, filename, Resources::Type::Texture));
+}
+
+FontHandle ResourceManager::loadFontAsync(const std::string& filename) {
+    return FontHandle(acquire(fonts, filename, Resources::Type::Font));
+}
+
+SoundBufferHandle ResourceManager::loadSoundBufferAsync(const std::string& filename) {
+    return SoundBufferHandle(acquire(soundBuffers, filename, Resources::Type::Sound));
+}
+
+AtlasRegionHandle ResourceManager::loadAtlasRegionAsync(const std::string& filename) {
+    return AtlasRegionHandle(acquire(atlasRegions, filename, Resources::Type::Atlas));
+}
+
+sf::Texture& ResourceManager::getTexture(const std::string& filename) {
+    TextureHandle handle = loadTextureAsync(filename);
+    wait(handle);
+    if (!handle.isReady()) {
+        throw std::runtime_error("Failed to load texture: " + filename);
+    }
+    handle.getSlot()->pinned = true;
+    return *handle.get();
+}
+
+sf::Font& ResourceManager::getFont(const std::string& filename) {
+    FontHandle handle = loadFontAsync(filename);
+    wait(handle);
+    if (!handle.isReady()) {
+        throw std::runtime_error("Failed to load font: " + filename);
+    }
+    handle.getSlot()->pinned = true;
+    return *handle.get();
+}
+
+sf::SoundBuffer& ResourceManager::getSoundBuffer(const std::string& filename) {
+    SoundBufferHandle handle = loadSoundBufferAsync(filename);
+    wait(handle);
+    if (!handle.isReady()) {
+        throw std::runtime_error("Failed to load sound buffer: " + filename);
+    }
+    handle.getSlot()->pinned = true;
+    return *handle.get();
+}
+
+const AtlasRegion& ResourceManager::getAtlasRegion(const std::string& filename) {
+    AtlasRegionHandle handle = loadAtlasRegionAsync(filename);
+    wait(handle);
+    if (!handle.isReady()) {
+        throw std::runtime_error("Failed to add image to atlas: " + filename);
+    }
+    handle.getSlot()->pinned = true;
+    return *handle.get();
+}
+
+bool ResourceManager::mountArchive(const std::string& filename) {
+    return archive.open(filename);
+}
+
+void ResourceManager::loadManifest(const std::string& filename) {
+    std::ifstream manifest(filename);
+    if (!manifest) {
+        throw std::runtime_error("Failed to open resource manifest: " + filename);
+    }
+    
+    std::string line;
+    while (std::getline(manifest, line)) {
+        std::istringstream fields(line);
+        std::string type;
+        std::string path;
+        fields >> type >> std::ws;
+        std::getline(fields, path);
+        if (type.empty() || type[0] == '#') continue;
+        
+        if (type == "texture") {
+            loadTextureAsync(path);
+        } else if (type == "font") {
+            loadFontAsync(path);
+        } else if (type == "sound") {
+            loadSoundBufferAsync(path);
+        } else if (type == "atlas") {
+            loadAtlasRegionAsync(path);
+        } else {
+            throw std::runtime_error("Unknown resource type '" + type + "' in manifest: " + filename);
+        }
+    }
+}
+
+std::size_t ResourceManager::processUploads(float budgetMicroseconds) {
+    auto start = std::chrono::steady_clock::now();
+    std::size_t uploaded = 0;
+    
+    while (true) {
+        std::shared_ptr<Resources::Slot> slot;
+        {
+            std::lock_guard<std::mutex> lock(uploadMutex);
+            if (uploadQueue.empty()) break;
+            slot = std::move(uploadQueue.front());
+            uploadQueue.pop_front();
+        }
+        
+        // Slots finished early by wait() are already uploaded, and slots dropped by
+        // clear() with no handles left aren't worth uploading
+        if (slot->state == Resources::LoadState::Decoded) {
+            if (slot.use_count() == 1) {
+                slot->state = Resources::LoadState::Failed;
+                pendingLoads--;
+                continue;
+            }
+            upload(*slot);
+            uploaded++;
+        }
+        
+        float elapsed = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count();
+        if (elapsed >= budgetMicroseconds) break;
+    }
+    
+    // Released handles and new uploads can both push a type over budget
+    enforceBudgets();
+    return uploaded;
+}
+
+void ResourceManager::clear() {
+    std::unique_lock<std::shared_mutex> lock(cacheMutex);
+    
+    // Stop counting cached resources as resource memory
+    auto forget = [](const auto& cache) {
+        for (const auto& entry : cache) {
+            if (entry.second->state == Resources::LoadState::Ready) {
+                Memory::recordFree(Memory::Tag::Resources, entry.second->bytes);
+            }
+        }
+    };
+    forget(textures);
+    forget(fonts);
+    forget(soundBuffers);
+    forget(atlasRegions);
+    
+    textures.clear();
+    fonts.clear();
+    soundBuffers.clear();
+    atlasRegions.clear();
+    atlas = TextureAtlas(atlas.getPageSize(), atlas.getPadding());
+    
+    // Resources still held through handles are no longer tracked
+    for (auto& typeCounters : counters) {
+        typeCounters.residentBytes = 0;
+        typeCounters.resourceCount = 0;
+    }
+}
+
+void ResourceManager::setMemoryBudget(Resources::Type type, std::size_t bytes) {
+    counters[static_cast<std::size_t>(type)].budgetBytes = bytes;
+    enforceBudgets();
+}
+
+ResourceStats ResourceManager::getStats(Resources::Type type) const {
+    const TypeCounters& typeCounters = counters[static_cast<std::size_t>(type)];
+    
+    ResourceStats stats;
+    stats.residentBytes = typeCounters.residentBytes;
+    stats.budgetBytes = typeCounters.budgetBytes;
+    stats.resourceCount = typeCounters.resourceCount;
+    stats.hits = typeCounters.hits;
+    stats.misses = typeCounters.misses;
+    stats.evictions = typeCounters.evictions;
+    return stats;
+}
+
+std::vector<AssetStats> ResourceManager::getAssetStats() const {
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
+    std::vector<AssetStats> stats;
+    collectStats(textures, stats);
+    collectStats(fonts, stats);
+    collectStats(soundBuffers, stats);
+    collectStats(atlasRegions, stats);
+    return stats;
+}
+
+void ResourceManager::enforceBudgets() {
+    auto overBudget = [this](Resources::Type type) {
+        const TypeCounters& typeCounters = counters[static_cast<std::size_t>(type)];
+        return typeCounters.budgetBytes > 0 && typeCounters.residentBytes > typeCounters.budgetBytes;
+    };
+    
+    // Cheap check first; eviction needs the exclusive lock
+    if (!overBudget(Resources::Type::Texture) && !overBudget(Resources::Type::Font) &&
+        !overBudget(Resources::Type::Sound)) {
+        return;
+    }
+    
+    std::unique_lock<std::shared_mutex> lock(cacheMutex);
+    evictFrom(textures, counters[static_cast<std::size_t>(Resources::Type::Texture)]);
+    evictFrom(fonts, counters[static_cast<std::size_t>(Resources::Type::Font)]);
+    evictFrom(soundBuffers, counters[static_cast<std::size_t>(Resources::Type::Sound)]);
+}
+
+template <typename SlotType>
+void ResourceManager::evictFrom(std::unordered_map<std::string, std::shared_ptr<SlotType>>& cache,
+                                TypeCounters& typeCounters) {
+    while (typeCounters.budgetBytes > 0 && typeCounters.residentBytes > typeCounters.budgetBytes) {
+        // Caches hold tens of assets, so a scan is cheaper than keeping an LRU list
+        // in order under concurrent lookups
+        auto oldest = cache.end();
+        for (auto it = cache.begin(); it != cache.end(); ++it) {
+            const SlotType& slot = *it->second;
+            bool evictable = slot.state == Resources::LoadState::Ready && !slot.pinned &&
+                             it->second.use_count() == 1;
+            if (evictable && (oldest == cache.end() || slot.lastUsed < oldest->second->lastUsed)) {
+                oldest = it;
+            }
+        }
+        
+        // Everything left is in use
+        if (oldest == cache.end()) return;
+        
+        typeCounters.residentBytes -= oldest->second->bytes;
+        typeCounters.resourceCount--;
+        typeCounters.evictions++;
+        Memory::recordFree(Memory::Tag::Resources, oldest->second->bytes);
+        cache.erase(oldest);
+    }
+}
+
+template <typename SlotType>
+void ResourceManager::collectStats(const std::unordered_map<std::string, std::shared_ptr<SlotType>>& cache,
+                                   std::vector<AssetStats>& stats) const {
+    for (const auto& [filename, slot] : cache) {
+        AssetStats asset;
+        asset.filename = filename;
+        asset.type = slot->type;
+        asset.state = slot->state;
+        asset.bytes = slot->bytes;
+        asset.loadMilliseconds = slot->loadMilliseconds;
+        asset.references = slot.use_count() - 1;
+        asset.pinned = slot->pinned;
+        stats.push_back(asset);
+    }
+}
+
+template <typename SlotType>
+std::shared_ptr<SlotType> ResourceManager::acquire(std::unordered_map<std::string, std::shared_ptr<SlotType>>& cache,
+                                                   const std::string& filename, Resources::Type type) {
+    TypeCounters& typeCounters = counters[static_cast<std::size_t>(type)];
+    {
+        std::shared_lock<std::shared_mutex> lock(cacheMutex);
+        auto it = cache.find(filename);
+        if (it != cache.end()) {
+            it->second->lastUsed = ++accessClock;
+            typeCounters.hits++;
+            return it->second;
+        }
+    }
+    
+    std::shared_ptr<SlotType> slot;
+    {
+        std::unique_lock<std::shared_mutex> lock(cacheMutex);
+        
+        // Another thread may have added it between the two locks
+        auto it = cache.find(filename);
+        if (it != cache.end()) {
+            it->second->lastUsed = ++accessClock;
+            typeCounters.hits++;
+            return it->second;
+        }
+        
+        slot = std::make_shared<SlotType>(filename);
+        slot->type = type;
+        slot->lastUsed = ++accessClock;
+        cache[filename] = slot;
+        typeCounters.misses++;
+    }
+    
+    enqueue(slot);
+    return slot;
+}
+
+void ResourceManager::finish(const std::shared_ptr<Resources::Slot>& slot) {
+    // Decode here rather than wait behind other queued files
+    tryDecode(slot);
+    
+    {
+        std::unique_lock<std::mutex> lock(uploadMutex);
+        decodedCondition.wait(lock, [&slot] {
+            Resources::LoadState state = slot->state;
+            return state != Resources::LoadState::Queued && state != Resources::LoadState::Decoding;
+        });
+    }
+    
+    if (slot->state == Resources::LoadState::Decoded) {
+        upload(*slot);
+    }
+}
+
+bool ResourceManager::tryDecode(const std::shared_ptr<Resources::Slot>& slot) {
+    if (slot->claimed.exchange(true)) {
+        return false;
+    }
+    
+    slot->state = Resources::LoadState::Decoding;
+    auto start = std::chrono::steady_clock::now();
+    bool decoded = false;
+    try {
+        decoded = slot->decode();
+    } catch (const std::exception&) {
+        decoded = false;
+    }
+    slot->loadMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    
+    {
+        std::lock_guard<std::mutex> lock(uploadMutex);
+        if (decoded) {
+            slot->state = Resources::LoadState::Decoded;
+            uploadQueue.push_back(slot);
+        } else {
+            slot->state = Resources::LoadState::Failed;
+            pendingLoads--;
+        }
+    }
+    decodedCondition.notify_all();
+    return true;
+}
+
+void ResourceManager::upload(Resources::Slot& slot) {
+    auto start = std::chrono::steady_clock::now();
+    bool uploaded = slot.upload();
+    slot.loadMilliseconds += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    
+    if (uploaded) {
+        TypeCounters& typeCounters = counters[static_cast<std::size_t>(slot.type)];
+        typeCounters.residentBytes += slot.bytes;
+        typeCounters.resourceCount++;
+        Memory::recordAllocation(Memory::Tag::Resources, slot.bytes);
+    }
+    slot.state = uploaded ? Resources::LoadState::Ready : Resources::LoadState::Failed;
+    pendingLoads--;
+}
+
+void ResourceManager::enqueue(std::shared_ptr<Resources::Slot> slot) {
+    pendingLoads++;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (workers.empty()) {
+            startWorkers();
+        }
+        decodeQueue.push_back(std::move(slot));
+    }
+    queueCondition.notify_one();
+}
+
+void ResourceManager::startWorkers() {
+    // Loading is mostly I/O; a few threads are enough and leave cores for the game
+    unsigned count = std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u);
+    for (unsigned i = 0; i < count; ++i) {
+        workers.emplace_back(&ResourceManager::workerLoop, this);
+    }
+}
+
+void ResourceManager::workerLoop() {
+    while (true) {
+        std::shared_ptr<Resources::Slot> slot;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this] { return stopping || !decodeQueue.empty(); });
+            if (stopping) return;
+            slot = std::move(decodeQueue.front());
+            decodeQueue.pop_front();
+        }
+        
+        tryDecode(slot);
+    }
+}
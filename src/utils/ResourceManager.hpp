@@ -2,10 +2,155 @@
 
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
-#include <unordered_map>
-#include <string>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "TextureAtlas.hpp"
+#include "AssetArchive.hpp"
+
+// Loading is split in two: files are read and decoded on worker threads,
+// then handed to SFML objects on the main thread (GPU upload for textures).
+namespace Resources {
+    enum class LoadState {
+        Queued,     // Waiting for a worker
+        Decoding,   // A worker is reading the file
+        Decoded,    // Waiting for the main thread to upload
+        Ready,
+        Failed
+    };
+    
+    // Each type has its own memory budget and stats
+    enum class Type {
+        Texture,
+        Font,
+        Sound,
+        Atlas,
+        Count
+    };
+    
+    struct Slot {
+        explicit Slot(const std::string& filename) : filename(filename) {}
+        virtual ~Slot() = default;
+        
+        // Worker thread: disk and CPU work only. Returns false on failure.
+        virtual bool decode() = 0;
+        
+        // Main thread: create the SFML resource from the decoded data
+        virtual bool upload() = 0;
+        
+        std::string filename;
+        std::atomic<LoadState> state{LoadState::Queued};
+        std::atomic<bool> claimed{false};    // Set by whichever thread decodes it
+        
+        // Bookkeeping for budgets and stats
+        Type type = Type::Texture;
+        std::size_t bytes = 0;                  // Resident size, set by upload()
+        float loadMilliseconds = 0.f;           // Decode plus upload time
+        std::atomic<std::uint64_t> lastUsed{0}; // Access clock value of the latest lookup
+        bool pinned = false;                    // Handed out as a plain reference; never evicted
+    };
+    
+    struct TextureSlot : Slot {
+        using Slot::Slot;
+        bool decode() override;
+        bool upload() override;
+        
+        sf::Image image;
+        sf::Texture value;
+    };
+    
+    struct FontSlot : Slot {
+        using Slot::Slot;
+        bool decode() override;
+        bool upload() override;
+        
+        std::vector<char> data;             // Font file, unless it is read from the archive mapping
+        const void* source = nullptr;       // sf::Font reads from this for its whole lifetime
+        std::size_t sourceSize = 0;
+        sf::Font value;
+    };
+    
+    struct SoundSlot : Slot {
+        using Slot::Slot;
+        bool decode() override;
+        bool upload() override;
+        
+        std::vector<std::int16_t> samples;
+        unsigned channelCount = 0;
+        unsigned sampleRate = 0;
+        std::vector<sf::SoundChannel> channelMap;
+        sf::SoundBuffer value;
+    };
+    
+    // An image packed into the shared texture atlas
+    struct AtlasSlot : Slot {
+        using Slot::Slot;
+        bool decode() override;
+        bool upload() override;
+        
+        sf::Image image;
+        AtlasRegion value;
+    };
+}
+
+// Future-like reference to a resource that may still be loading
+template <typename SlotType>
+class ResourceHandle {
+public:
+    using Resource = decltype(SlotType::value);
+    
+    ResourceHandle() = default;
+    explicit ResourceHandle(std::shared_ptr<SlotType> slot) : slot(std::move(slot)) {}
+    
+    bool isValid() const { return slot != nullptr; }
+    bool isReady() const { return slot && slot->state == Resources::LoadState::Ready; }
+    bool hasFailed() const { return slot && slot->state == Resources::LoadState::Failed; }
+    
+    // The resource, or nullptr while it is still loading
+    Resource* get() const { return isReady() ? &slot->value : nullptr; }
+    
+    const std::string& getFilename() const { return slot->filename; }
+    const std::shared_ptr<SlotType>& getSlot() const { return slot; }
+
+private:
+    std::shared_ptr<SlotType> slot;
+};
+
+using TextureHandle = ResourceHandle<Resources::TextureSlot>;
+using FontHandle = ResourceHandle<Resources::FontSlot>;
+using SoundBufferHandle = ResourceHandle<Resources::SoundSlot>;
+using AtlasRegionHandle = ResourceHandle<Resources::AtlasSlot>;
+
+// Memory and cache counters for one resource type
+struct ResourceStats {
+    std::size_t residentBytes = 0;
+    std::size_t budgetBytes = 0;    // 0 means unlimited
+    std::size_t resourceCount = 0;
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t evictions = 0;
+};
+
+// Per-asset details for debugging memory use
+struct AssetStats {
+    std::string filename;
+    Resources::Type type;
+    Resources::LoadState state;
+    std::size_t bytes;
+    float loadMilliseconds;
+    long references;    // Handles held outside the manager
+    bool pinned;
+};
 
 // Singleton ResourceManager for efficiently managing textures, sounds, fonts, etc.
 class ResourceManager {
@@ -16,67 +161,63 @@ public:
         return instance;
     }
     
-    // Load a texture from file (or get it from cache if already loaded)
-    sf::Texture& getTexture(const std::string& filename) {
-        auto it = textures.find(filename);
-        if (it != textures.end()) {
-            return *it->second;
-        }
-        
-        auto texture = std::make_unique<sf::Texture>();
-        if (!texture->loadFromFile(filename)) {
-            throw std::runtime_error("Failed to load texture: " + filename);
-        }
-        
-        sf::Texture& result = *texture;
-        textures[filename] = std::move(texture);
-        return result;
-    }
+    // Start loading in the background (or get the cached handle)
+    TextureHandle loadTextureAsync(const std::string& filename);
+    FontHandle loadFontAsync(const std::string& filename);
+    SoundBufferHandle loadSoundBufferAsync(const std::string& filename);
+    AtlasRegionHandle loadAtlasRegionAsync(const std::string& filename);
     
-    // Load a font from file (or get it from cache if already loaded)
-    sf::Font& getFont(const std::string& filename) {
-        auto it = fonts.find(filename);
-        if (it != fonts.end()) {
-            return *it->second;
-        }
-        
-        auto font = std::make_unique<sf::Font>();
-        if (!font->loadFromFile(filename)) {
-            throw std::runtime_error("Failed to load font: " + filename);
-        }
-        
-        sf::Font& result = *font;
-        fonts[filename] = std::move(font);
-        return result;
-    }
+    // Load a resource (or get it from cache if already loaded), blocking until it's ready.
+    // Main thread only; throws if the file can't be loaded. Resources returned as plain
+    // references are pinned and never evicted; use handles for budgeted resources.
+    sf::Texture& getTexture(const std::string& filename);
+    sf::Font& getFont(const std::string& filename);
+    sf::SoundBuffer& getSoundBuffer(const std::string& filename);
     
-    // Load a sound buffer from file (or get it from cache if already loaded)
-    sf::SoundBuffer& getSoundBuffer(const std::string& filename) {
-        auto it = soundBuffers.find(filename);
-        if (it != soundBuffers.end()) {
-            return *it->second;
-        }
-        
-        auto soundBuffer = std::make_unique<sf::SoundBuffer>();
-        if (!soundBuffer->loadFromFile(filename)) {
-            throw std::runtime_error("Failed to load sound buffer: " + filename);
-        }
-        
-        sf::SoundBuffer& result = *soundBuffer;
-        soundBuffers[filename] = std::move(soundBuffer);
-        return result;
-    }
+    // Pack an image into the shared atlas instead of giving it its own texture.
+    // Sprites using regions from the same atlas page can be drawn in one batch.
+    const AtlasRegion& getAtlasRegion(const std::string& filename);
     
-    // Clear all cached resources
-    void clear() {
-        textures.clear();
-        fonts.clear();
-        soundBuffers.clear();
+    // Main thread only
+    TextureAtlas& getAtlas() { return atlas; }
+    
+    // Read assets from a packed archive instead of separate files, falling back to the
+    // file system for paths it doesn't contain. Call before queueing any loads.
+    bool mountArchive(const std::string& filename);
+    const AssetArchive& getArchive() const { return archive; }
+    
+    // Queue every asset listed in a manifest. Each line is "<texture|font|sound|atlas> <path>";
+    // blank lines and lines starting with '#' are skipped.
+    void loadManifest(const std::string& filename);
+    
+    // Main thread, once per frame: upload decoded resources for up to budgetMicroseconds
+    // (at least one upload is always made, so loading can't stall)
+    std::size_t processUploads(float budgetMicroseconds);
+    
+    // Finish a load right now on the calling (main) thread
+    template <typename SlotType>
+    void wait(const ResourceHandle<SlotType>& handle) {
+        if (handle.isValid()) finish(handle.getSlot());
     }
     
+    // Resources queued or waiting for upload
+    std::size_t getPendingCount() const { return pendingLoads.load(); }
+    
+    // Limit the resident size of one resource type (0 for unlimited). When over budget,
+    // the least recently used resources with no outstanding handles are evicted.
+    // Atlas pages can't give space back, so atlas images are never evicted.
+    void setMemoryBudget(Resources::Type type, std::size_t bytes);
+    
+    ResourceStats getStats(Resources::Type type) const;
+    std::vector<AssetStats> getAssetStats() const;
+    
+    // Clear all cached resources (atlas regions from before are invalidated)
+    void clear();
+
 private:
     // Private constructor for singleton
     ResourceManager() = default;
+    ~ResourceManager();
     
     // Delete copy and move constructors and assignment operators
     ResourceManager(const ResourceManager&) = delete;
@@ -84,8 +225,71 @@ private:
     ResourceManager(ResourceManager&&) = delete;
     ResourceManager& operator=(ResourceManager&&) = delete;
     
-    // Resource caches
-    std::unordered_map<std::string, std::unique_ptr<sf::Texture>> textures;
-    std::unordered_map<std::string, std::unique_ptr<sf::Font>> fonts;
-    std::unordered_map<std::string, std::unique_ptr<sf::SoundBuffer>> soundBuffers;
-}; 
\ No newline at end of file
+    struct TypeCounters {
+        std::atomic<std::size_t> residentBytes{0};
+        std::atomic<std::size_t> resourceCount{0};
+        std::atomic<std::uint64_t> hits{0};
+        std::atomic<std::uint64_t> misses{0};
+        std::atomic<std::uint64_t> evictions{0};
+        std::size_t budgetBytes = 0;
+    };
+    
+    static const std::size_t TypeCount = static_cast<std::size_t>(Resources::Type::Count);
+    
+    // Find or create the cache entry for filename, queueing new entries for decoding
+    template <typename SlotType>
+    std::shared_ptr<SlotType> acquire(std::unordered_map<std::string, std::shared_ptr<SlotType>>& cache,
+                                      const std::string& filename, Resources::Type type);
+    
+    // Evict least recently used entries until every type is within its budget (main thread)
+    void enforceBudgets();
+    
+    template <typename SlotType>
+    void evictFrom(std::unordered_map<std::string, std::shared_ptr<SlotType>>& cache, TypeCounters& typeCounters);
+    
+    template <typename SlotType>
+    void collectStats(const std::unordered_map<std::string, std::shared_ptr<SlotType>>& cache,
+                      std::vector<AssetStats>& stats) const;
+    
+    // Blocking path behind get*() and wait()
+    void finish(const std::shared_ptr<Resources::Slot>& slot);
+    
+    // Decode a slot if no other thread has claimed it
+    bool tryDecode(const std::shared_ptr<Resources::Slot>& slot);
+    void upload(Resources::Slot& slot);
+    
+    void enqueue(std::shared_ptr<Resources::Slot> slot);
+    void startWorkers();
+    void workerLoop();
+    
+    // Resource caches (shared lock for lookups, exclusive to insert)
+    mutable std::shared_mutex cacheMutex;
+    std::unordered_map<std::string, std::shared_ptr<Resources::TextureSlot>> textures;
+    std::unordered_map<std::string, std::shared_ptr<Resources::FontSlot>> fonts;
+    std::unordered_map<std::string, std::shared_ptr<Resources::SoundSlot>> soundBuffers;
+    std::unordered_map<std::string, std::shared_ptr<Resources::AtlasSlot>> atlasRegions;
+    
+    // Shared texture pages for atlas images
+    TextureAtlas atlas;
+    
+    // Mounted asset pack (read-only once mounted, so workers read it without locks)
+    AssetArchive archive;
+    
+    // Decode work for the loader threads
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    std::deque<std::shared_ptr<Resources::Slot>> decodeQueue;
+    std::vector<std::thread> workers;
+    bool stopping = false;
+    
+    // Decoded resources waiting for the main thread
+    std::mutex uploadMutex;
+    std::condition_variable decodedCondition;
+    std::deque<std::shared_ptr<Resources::Slot>> uploadQueue;
+    
+    std::atomic<std::size_t> pendingLoads{0};
+    
+    // Budgets and stats
+    std::array<TypeCounters, TypeCount> counters;
+    std::atomic<std::uint64_t> accessClock{0};
+};
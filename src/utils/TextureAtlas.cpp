@@ -0,0 +1,144 @@
+#include "TextureAtlas.hpp"
+#include <algorithm>
+#include <limits>
+
+SkylinePacker::SkylinePacker(unsigned width, unsigned height)
+    : width(width)
+    , height(height)
+    , usedArea(0)
+{
+    skyline.push_back({0, 0, width});
+}
+
+std::optional<sf::Vector2u> SkylinePacker::insert(unsigned rectWidth, unsigned rectHeight) {
+    // Pick the position with the lowest top edge, then the narrowest node
+    std::size_t bestIndex = skyline.size();
+    long bestTop = std::numeric_limits<long>::max();
+    unsigned bestWidth = std::numeric_limits<unsigned>::max();
+    
+    for (std::size_t i = 0; i < skyline.size(); ++i) {
+        long y = fit(i, rectWidth, rectHeight);
+        if (y < 0) continue;
+        
+        long top = y + static_cast<long>(rectHeight);
+        if (top < bestTop || (top == bestTop && skyline[i].width < bestWidth)) {
+            bestIndex = i;
+            bestTop = top;
+            bestWidth = skyline[i].width;
+        }
+    }
+    
+    if (bestIndex == skyline.size()) {
+        return std::nullopt;
+    }
+    
+    sf::Vector2u position(skyline[bestIndex].x, static_cast<unsigned>(bestTop) - rectHeight);
+    
+    // Raise the skyline over the new rectangle
+    Node raised{position.x, static_cast<unsigned>(bestTop), rectWidth};
+    skyline.insert(skyline.begin() + bestIndex, raised);
+    
+    // Trim or remove the nodes now underneath it
+    unsigned right = raised.x + raised.width;
+    for (std::size_t i = bestIndex + 1; i < skyline.size();) {
+        if (skyline[i].x >= right) break;
+        
+        unsigned shrink = right - skyline[i].x;
+        if (skyline[i].width <= shrink) {
+            skyline.erase(skyline.begin() + i);
+        } else {
+            skyline[i].x += shrink;
+            skyline[i].width -= shrink;
+            break;
+        }
+    }
+    
+    // Merge neighbours at the same height
+    for (std::size_t i = 0; i + 1 < skyline.size();) {
+        if (skyline[i].y == skyline[i + 1].y) {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + i + 1);
+        } else {
+            ++i;
+        }
+    }
+    
+    usedArea += static_cast<unsigned long long>(rectWidth) * rectHeight;
+    return position;
+}
+
+long SkylinePacker::fit(std::size_t index, unsigned rectWidth, unsigned rectHeight) const {
+    if (skyline[index].x + rectWidth > width) return -1;
+    
+    // The rectangle rests on the highest node it spans
+    unsigned y = 0;
+    long widthLeft = rectWidth;
+    for (std::size_t i = index; widthLeft > 0; ++i) {
+        if (i == skyline.size()) return -1;
+        y = std::max(y, skyline[i].y);
+        if (y + rectHeight > height) return -1;
+        widthLeft -= skyline[i].width;
+    }
+    return y;
+}
+
+float SkylinePacker::getOccupancy() const {
+    return static_cast<float>(usedArea) / (static_cast<float>(width) * height);
+}
+
+TextureAtlas::TextureAtlas(unsigned pageSize, unsigned padding)
+    : pageSize(pageSize)
+    , padding(padding)
+{
+}
+
+std::optional<AtlasRegion> TextureAtlas::add(const std::string& name, const sf::Image& image) {
+    if (const AtlasRegion* existing = find(name)) {
+        return *existing;
+    }
+    
+    sf::Vector2u size = image.getSize();
+    unsigned paddedWidth = size.x + padding;
+    unsigned paddedHeight = size.y + padding;
+    if (paddedWidth > pageSize || paddedHeight > pageSize) {
+        return std::nullopt;
+    }
+    
+    // Try the existing pages first, newest (least full) first
+    std::optional<sf::Vector2u> position;
+    std::size_t pageIndex = pages.size();
+    while (pageIndex > 0 && !position) {
+        --pageIndex;
+        position = pages[pageIndex]->packer.insert(paddedWidth, paddedHeight);
+    }
+    
+    // Open a new page when none has room
+    if (!position) {
+        auto page = std::make_unique<Page>(pageSize);
+        if (!page->texture.resize({pageSize, pageSize})) {
+            return std::nullopt;
+        }
+        position = page->packer.insert(paddedWidth, paddedHeight);
+        pages.push_back(std::move(page));
+        pageIndex = pages.size() - 1;
+    }
+    
+    // Upload only the new image's pixels
+    Page& page = *pages[pageIndex];
+    page.texture.update(image, *position);
+    
+    AtlasRegion region;
+    region.texture = &page.texture;
+    region.rect = sf::IntRect(sf::Vector2i(*position), sf::Vector2i(size));
+    region.uv = sf::FloatRect({static_cast<float>(position->x) / pageSize, static_cast<float>(position->y) / pageSize},
+                              {static_cast<float>(size.x) / pageSize, static_cast<float>(size.y) / pageSize});
+    region.page = pageIndex;
+    
+    regions[name] = region;
+    return region;
+}
+
+const AtlasRegion* TextureAtlas::find(const std::string& name) const {
+    auto it = regions.find(name);
+    return it != regions.end() ? &it->second : nullptr;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Part of an atlas page holding one packed image
+struct AtlasRegion {
+    const sf::Texture* texture = nullptr;
+    sf::IntRect rect;       // Pixels, for sf::Sprite::setTextureRect and vertex texCoords
+    sf::FloatRect uv;       // Normalised to [0, 1]
+    std::size_t page = 0;
+};
+
+// Skyline bottom-left rectangle packer. The skyline is the top edge of
+// everything placed so far; each rectangle goes where it ends up lowest.
+class SkylinePacker {
+public:
+    SkylinePacker(unsigned width, unsigned height);
+    
+    // Reserve a width x height area, or nothing if it doesn't fit
+    std::optional<sf::Vector2u> insert(unsigned width, unsigned height);
+    
+    // Fraction of the area covered by packed rectangles
+    float getOccupancy() const;
+    
+private:
+    struct Node {
+        unsigned x;
+        unsigned y;
+        unsigned width;
+    };
+    
+    // Top of a rectangle placed at node index, or -1 if it doesn't fit there
+    long fit(std::size_t index, unsigned width, unsigned height) const;
+    
+    unsigned width;
+    unsigned height;
+    unsigned long long usedArea;
+    std::vector<Node> skyline;
+};
+
+// Packs images into a few large textures so sprites from different images
+// can share one texture (and one draw call). Images are added incrementally:
+// each new image goes into free space on an existing page and only its own
+// pixels are uploaded, and a new page is opened when none has room.
+class TextureAtlas {
+public:
+    explicit TextureAtlas(unsigned pageSize = 2048, unsigned padding = 1);
+    
+    // Pack an image under name (main thread). Returns the existing region if the
+    // name is already packed, or nothing if the image is larger than a page.
+    std::optional<AtlasRegion> add(const std::string& name, const sf::Image& image);
+    
+    // Region for a packed image, nullptr if it hasn't been added
+    const AtlasRegion* find(const std::string& name) const;
+    
+    std::size_t getPageCount() const { return pages.size(); }
+    const sf::Texture& getPageTexture(std::size_t page) const { return pages[page]->texture; }
+    std::size_t getRegionCount() const { return regions.size(); }
+    unsigned getPageSize() const { return pageSize; }
+    unsigned getPadding() const { return padding; }
+    
+private:
+    struct Page {
+        explicit Page(unsigned size) : packer(size, size) {}
+        
+        SkylinePacker packer;
+        sf::Texture texture;
+    };
+    
+    unsigned pageSize;
+    unsigned padding;   // Empty pixels between images so filtering doesn't bleed
+    std::vector<std::unique_ptr<Page>> pages;
+    std::unordered_map<std::string, AtlasRegion> regions;
+};
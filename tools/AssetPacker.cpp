@@ -0,0 +1,75 @@
+// Packs asset files into an archive that ResourceManager can mount.
+// Files are stored under their path relative to the working directory, so
+// run it from the directory the game is started from.
+//
+// Usage: asset-pack [--compress] <out.pack> <file or directory>...
+
+#include "../src/utils/AssetArchive.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    void printUsage() {
+        std::cerr << "Usage: asset-pack [--compress] <out.pack> <file or directory>...\n";
+    }
+    
+    bool readFile(const std::filesystem::path& path, std::vector<char>& data) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) return false;
+        data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        return true;
+    }
+    
+    bool addFile(const std::filesystem::path& path, std::vector<AssetArchive::File>& files) {
+        AssetArchive::File asset;
+        asset.name = path.lexically_normal().generic_string();
+        if (!readFile(path, asset.data)) {
+            std::cerr << "Failed to read: " << path.string() << "\n";
+            return false;
+        }
+        files.push_back(std::move(asset));
+        return true;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    
+    bool compress = !args.empty() && args[0] == "--compress";
+    if (compress) args.erase(args.begin());
+    
+    if (args.size() < 2) {
+        printUsage();
+        return 1;
+    }
+    
+    std::vector<AssetArchive::File> files;
+    for (std::size_t i = 1; i < args.size(); ++i) {
+        std::filesystem::path input(args[i]);
+        if (std::filesystem::is_directory(input)) {
+            // Sorted so the archive is the same from run to run
+            std::vector<std::filesystem::path> paths;
+            for (const auto& item : std::filesystem::recursive_directory_iterator(input)) {
+                if (item.is_regular_file()) paths.push_back(item.path());
+            }
+            std::sort(paths.begin(), paths.end());
+            for (const auto& path : paths) {
+                if (!addFile(path, files)) return 1;
+            }
+        } else if (!addFile(input, files)) {
+            return 1;
+        }
+    }
+    
+    if (!AssetArchive::save(args[0], files, compress)) {
+        std::cerr << "Failed to write archive (or two files share a name hash): " << args[0] << "\n";
+        return 1;
+    }
+    
+    std::cout << "Packed " << files.size() << " files into " << args[0] << "\n";
+    return 0;
+}
@@ -0,0 +1,166 @@
+// Converts mini golf courses between the binary course format and an
+// editable CSV text form, and generates courses from a seed.
+//
+// CSV layout (rows after a "chunk" row belong to that chunk):
+//   seed,<seed>
+//   chunk,<index>
+//   segment,<startX>,<startY>,<endX>,<endY>,<width>
+//   wall,<x>,<y>,<width>,<height>,<rotation>,<rgba>
+
+#include "../src/core/JobSystem.hpp"
+#include "../src/systems/CourseFile.hpp"
+#include "../src/systems/ObstacleGenerator.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    void printUsage() {
+        std::cerr << "Usage:\n"
+                  << "  course-convert generate <seed> <chunkCount> <out.course>\n"
+                  << "  course-convert export <in.course> <out.csv>\n"
+                  << "  course-convert import <in.csv> <out.course>\n";
+    }
+    
+    std::vector<std::string> splitFields(const std::string& line) {
+        std::vector<std::string> fields;
+        std::istringstream stream(line);
+        std::string field;
+        while (std::getline(stream, field, ',')) {
+            fields.push_back(field);
+        }
+        return fields;
+    }
+    
+    int generateCourse(std::uint64_t seed, int chunkCount, const std::string& output) {
+        // Validation runs are played on every core
+        JobSystem jobs;
+        ObstacleGenerator generator(seed);
+        generator.setJobSystem(&jobs);
+        
+        std::vector<CourseChunk> chunks;
+        for (int chunk = 0; chunk < chunkCount; ++chunk) {
+            chunks.push_back(generator.generateChunk(chunk));
+        }
+        
+        if (!CourseFile::save(output, seed, std::move(chunks))) {
+            std::cerr << "Failed to write course: " << output << "\n";
+            return 1;
+        }
+        return 0;
+    }
+    
+    int exportCourse(const std::string& input, const std::string& output) {
+        CourseFile course;
+        if (!course.open(input)) {
+            std::cerr << "Failed to open course: " << input << "\n";
+            return 1;
+        }
+        
+        std::ofstream out(output);
+        if (!out) {
+            std::cerr << "Failed to write CSV: " << output << "\n";
+            return 1;
+        }
+        
+        out << std::setprecision(9);
+        out << "seed," << course.getSeed() << "\n";
+        for (std::uint32_t i = 0; i < course.getChunkCount(); ++i) {
+            CourseChunk chunk = course.readChunk(course.chunkAt(i));
+            out << "chunk," << chunk.index << "\n";
+            for (const auto& segment : chunk.segments) {
+                out << "segment," << segment.start.x << "," << segment.start.y << ","
+                    << segment.end.x << "," << segment.end.y << "," << segment.width << "\n";
+            }
+            for (const auto& wall : chunk.walls) {
+                out << "wall," << wall.position.x << "," << wall.position.y << ","
+                    << wall.size.x << "," << wall.size.y << "," << wall.rotation << ","
+                    << wall.color.toInteger() << "\n";
+            }
+        }
+        return 0;
+    }
+    
+    int importCourse(const std::string& input, const std::string& output) {
+        std::ifstream in(input);
+        if (!in) {
+            std::cerr << "Failed to open CSV: " << input << "\n";
+            return 1;
+        }
+        
+        std::uint64_t seed = 0;
+        std::vector<CourseChunk> chunks;
+        std::string line;
+        int lineNumber = 0;
+        
+        while (std::getline(in, line)) {
+            ++lineNumber;
+            std::vector<std::string> fields = splitFields(line);
+            if (fields.empty() || fields[0].empty()) continue;
+            
+            const std::string& kind = fields[0];
+            bool needsChunk = kind == "segment" || kind == "wall";
+            if (needsChunk && chunks.empty()) {
+                std::cerr << input << ":" << lineNumber << ": " << kind << " before any chunk\n";
+                return 1;
+            }
+            
+            try {
+                if (kind == "seed" && fields.size() == 2) {
+                    seed = std::stoull(fields[1]);
+                } else if (kind == "chunk" && fields.size() == 2) {
+                    CourseChunk chunk;
+                    chunk.index = std::stoi(fields[1]);
+                    chunks.push_back(chunk);
+                } else if (kind == "segment" && fields.size() == 6) {
+                    PathSegment segment;
+                    segment.start = sf::Vector2f(std::stof(fields[1]), std::stof(fields[2]));
+                    segment.end = sf::Vector2f(std::stof(fields[3]), std::stof(fields[4]));
+                    segment.width = std::stof(fields[5]);
+                    chunks.back().segments.push_back(segment);
+                } else if (kind == "wall" && fields.size() == 7) {
+                    WallSpec wall;
+                    wall.position = sf::Vector2f(std::stof(fields[1]), std::stof(fields[2]));
+                    wall.size = sf::Vector2f(std::stof(fields[3]), std::stof(fields[4]));
+                    wall.rotation = std::stof(fields[5]);
+                    wall.color = sf::Color(static_cast<std::uint32_t>(std::stoul(fields[6])));
+                    chunks.back().walls.push_back(wall);
+                } else {
+                    std::cerr << input << ":" << lineNumber << ": malformed row\n";
+                    return 1;
+                }
+            } catch (const std::exception&) {
+                std::cerr << input << ":" << lineNumber << ": invalid number\n";
+                return 1;
+            }
+        }
+        
+        if (!CourseFile::save(output, seed, std::move(chunks))) {
+            std::cerr << "Failed to write course: " << output << "\n";
+            return 1;
+        }
+        return 0;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    
+    if (args.size() == 4 && args[0] == "generate") {
+        return generateCourse(std::strtoull(args[1].c_str(), nullptr, 10),
+                              std::atoi(args[2].c_str()), args[3]);
+    }
+    if (args.size() == 3 && args[0] == "export") {
+        return exportCourse(args[1], args[2]);
+    }
+    if (args.size() == 3 && args[0] == "import") {
+        return importCourse(args[1], args[2]);
+    }
+    
+    printUsage();
+    return 1;
+}